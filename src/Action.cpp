@@ -12,14 +12,26 @@
 */
 #include "Action.h"
 
+ActionPath::ActionPath()
+    : hexes_(),
+    size_{0}
+{
+}
+
 Action::Action()
     : path{},
     damage{0},
     type{ActionType::NONE},
-    attacker{-1},
-    defender{-1},
     aTgt{-1},
     manaCost{0},
+    fixedDamage{false},
+    attacker{-1},
+    defender{-1},
     effect{}
 {
 }
+
+void Action::reset()
+{
+    *this = Action{};
+}
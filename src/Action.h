@@ -14,11 +14,13 @@
 #define ACTION_H
 
 #include "Effects.h"
-#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 // Definition of a possible action a unit may take (where it can move, a target
 // to attack, etc.).
-enum class ActionType {
+enum class ActionType : int8_t {
     NONE,
     MOVE,
     ATTACK,
@@ -27,18 +29,120 @@ enum class ActionType {
     EFFECT
 };
 
+// Hexes a unit passes through when it moves, starting with the one it's in.
+// No unit moves more than a couple of hexes per turn, so they're stored
+// inline rather than on the heap.  Hex indexes are narrowed to 8 bits like
+// in PackedState.
+class ActionPath
+{
+public:
+    static const int MAX_SIZE = 7;
+
+    ActionPath();
+
+    template <class InputIter>
+    void assign(InputIter first, InputIter last);
+    void push_back(int aHex);
+    void clear();
+
+    unsigned size() const;
+    bool empty() const;
+    int operator[](unsigned i) const;
+    int back() const;
+
+    const int8_t * begin() const;
+    const int8_t * end() const;
+
+private:
+    int8_t hexes_[MAX_SIZE];
+    int8_t size_;
+};
+
+// Copying an action is a plain copy of a few dozen bytes, so they're cheap to
+// pass around by value and to keep in tables.
 struct Action
 {
-    std::vector<int> path;
+    ActionPath path;
     int damage;
     ActionType type;
-    int attacker;
-    int defender;
-    int aTgt;  // hex the defender is standing in
-    int manaCost;
+    int8_t aTgt;  // hex the defender is standing in
+    int8_t manaCost;
+    bool fixedDamage;  // in sim mode, use 'damage' as is
+    int16_t attacker;
+    int16_t defender;
     Effect effect;
 
     Action();
+
+    // Return to the default state.
+    void reset();
 };
 
+// Action lists and TT entries copy these around constantly, so keep them free
+// of heap members and from growing past their current layout.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 5
+// libstdc++ before gcc 5 (e.g., MinGW 4.7) has no is_trivially_copyable.
+static_assert(__has_trivial_copy(Action) && __has_trivial_assign(Action) &&
+              __has_trivial_destructor(Action),
+              "Action must be copyable with memcpy");
+#else
+static_assert(std::is_trivially_copyable<Action>::value,
+              "Action must be copyable with memcpy");
+#endif
+static_assert(sizeof(Action) <= 36, "Action has grown, check its layout");
+
+
+template <class InputIter>
+void ActionPath::assign(InputIter first, InputIter last)
+{
+    clear();
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+inline void ActionPath::push_back(int aHex)
+{
+    assert(size_ < MAX_SIZE);
+    assert(aHex == static_cast<int8_t>(aHex));
+    hexes_[size_++] = aHex;
+}
+
+inline void ActionPath::clear()
+{
+    size_ = 0;
+}
+
+inline unsigned ActionPath::size() const
+{
+    return size_;
+}
+
+inline bool ActionPath::empty() const
+{
+    return size_ == 0;
+}
+
+inline int ActionPath::operator[](unsigned i) const
+{
+    assert(i < size());
+    return hexes_[i];
+}
+
+inline int ActionPath::back() const
+{
+    assert(!empty());
+    return hexes_[size_ - 1];
+}
+
+inline const int8_t * ActionPath::begin() const
+{
+    return hexes_;
+}
+
+inline const int8_t * ActionPath::end() const
+{
+    return hexes_ + size_;
+}
+
 #endif
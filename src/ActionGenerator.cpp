@@ -0,0 +1,169 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "ActionGenerator.h"
+
+#include "Action.h"
+#include "GameState.h"
+#include "HexGrid.h"
+#include <cassert>
+
+ActionGenerator::ActionGenerator(const GameState &gs)
+    : gs_(gs),
+    id_{gs.getActiveUnit().entityId},
+    stage_{Stage::SKIP},
+    i_{0},
+    j_{0},
+    reachable_{},
+    neighbors_{},
+    index_{0}
+{
+    const auto &unit = gs_.getUnit(id_);
+    assert(unit.isAlive());
+
+    reachable_ = gs_.getReachable(unit);
+
+    if (gs_.canUseRangedAttack(id_)) {
+        stage_ = Stage::RANGED;
+    }
+    else if (gs_.canUseSpell(id_)) {
+        stage_ = Stage::SPELL;
+    }
+    else if (gs_.canUseMeleeAttack(id_)) {
+        stage_ = Stage::MELEE;
+        startMeleeHex();
+    }
+}
+
+bool ActionGenerator::next(Action &action)
+{
+    return advance(&action);
+}
+
+bool ActionGenerator::skip()
+{
+    return advance(nullptr);
+}
+
+int ActionGenerator::getIndex() const
+{
+    return index_;
+}
+
+bool ActionGenerator::advance(Action *action)
+{
+    const auto &unit = gs_.getUnit(id_);
+    const auto &units = gs_.units_;
+
+    while (stage_ != Stage::DONE) {
+        switch (stage_) {
+            case Stage::RANGED:
+                while (i_ < units.size()) {
+                    const auto &target = units[i_++];
+                    if (!target.isAlive() || !unit.isEnemy(target)) continue;
+
+                    if (action) {
+                        gs_.makeAttack(id_, target.entityId, unit.aHex,
+                                       *action);
+                    }
+                    ++index_;
+                    return true;
+                }
+                stage_ = Stage::SKIP;
+                break;
+
+            case Stage::SPELL:
+                // Have to build these to know whether they're allowed, but
+                // spells don't have a path so that's cheap.
+                while (i_ < units.size()) {
+                    const auto &target = units[i_++];
+                    if (!target.isAlive()) continue;
+
+                    Action spell;
+                    auto &possible = action ? *action : spell;
+                    gs_.makeAttack(id_, target.entityId, unit.aHex, possible);
+                    if (possible.type == ActionType::NONE) continue;
+
+                    ++index_;
+                    return true;
+                }
+                stage_ = Stage::SKIP;
+                break;
+
+            case Stage::MELEE:
+                while (i_ < reachable_.entries.size()) {
+                    while (j_ < neighbors_.size()) {
+                        const auto &target = gs_.getUnitAt(neighbors_[j_++]);
+                        if (!target.isAlive() || !unit.isEnemy(target)) {
+                            continue;
+                        }
+
+                        if (action) {
+                            gs_.makeAttack(id_, target.entityId,
+                                           reachable_.entries[i_].node, *action,
+                                           &reachable_);
+                        }
+                        ++index_;
+                        return true;
+                    }
+                    ++i_;
+                    startMeleeHex();
+                }
+                stage_ = Stage::SKIP;
+                break;
+
+            case Stage::SKIP:
+                if (action) {
+                    gs_.makeSkip(id_, *action);
+                }
+                stage_ = Stage::MOVE;
+                i_ = 0;
+                ++index_;
+                return true;
+
+            case Stage::MOVE:
+                while (i_ < reachable_.entries.size()) {
+                    int aHex = reachable_.entries[i_++].node;
+                    if (aHex == unit.aHex) continue;
+
+                    if (action) {
+                        gs_.makeMove(id_, aHex, *action, &reachable_);
+                    }
+                    ++index_;
+                    return true;
+                }
+                stage_ = Stage::DONE;
+                break;
+
+            default:
+                stage_ = Stage::DONE;
+                break;
+        }
+    }
+
+    return false;
+}
+
+void ActionGenerator::startMeleeHex()
+{
+    j_ = 0;
+    neighbors_.clear();
+    if (i_ >= reachable_.entries.size()) return;
+
+    // Most hexes have no enemies next to them, don't bother looking.
+    int aHex = reachable_.entries[i_].node;
+    auto enemyMask = gs_.occupied_[1 - gs_.getUnit(id_).team];
+    if ((gs_.grid_.aryNeighborMask(aHex) & enemyMask) == 0) return;
+
+    const auto &nbrs = gs_.grid_.aryNeighbors(aHex);
+    neighbors_.assign(std::begin(nbrs), std::end(nbrs));
+}
@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef ACTION_GENERATOR_H
+#define ACTION_GENERATOR_H
+
+#include "Pathfinder.h"
+#include <vector>
+
+struct Action;
+class GameState;
+
+// Produce the possible actions for the active unit one at a time, in the same
+// order as GameState::getPossibleActions().  A search that gets a cutoff
+// early doesn't have to build the rest.  Actions are written into storage
+// the caller owns.  The unit's reachable hexes are found once, and every
+// action's path comes from there.
+//
+// The game state must not change while the generator is in use.
+class ActionGenerator
+{
+public:
+    explicit ActionGenerator(const GameState &gs);
+
+    // Overwrite 'action' with the next possible action and return true, or
+    // return false if there are none left.
+    bool next(Action &action);
+
+    // Move past the next action without building it, return false if there
+    // are none left.  Cheaper than next() for anything with a path.
+    bool skip();
+
+    // Number of actions produced or skipped so far.
+    int getIndex() const;
+
+private:
+    enum class Stage { RANGED, SPELL, MELEE, SKIP, MOVE, DONE };
+
+    // Find the next action, building it if 'action' isn't null.
+    bool advance(Action *action);
+    void startMeleeHex();
+
+    const GameState &gs_;
+    int id_;
+    Stage stage_;
+    unsigned i_;  // current unit or reachable hex
+    unsigned j_;  // current neighbor of a reachable hex
+    ReachableSet reachable_;
+    std::vector<int> neighbors_;
+    int index_;
+};
+
+#endif
@@ -12,8 +12,9 @@
 */
 #include "Anim.h"
 #include "Battlefield.h"
-#include "Effects.h"
+#include "EffectArt.h"
 #include "Traits.h"
+#include "UnitArt.h"
 #include "algo.h"
 
 #include <algorithm>
@@ -26,9 +27,9 @@ namespace
     SdlSurface getBaseImage(const Unit &unit)
     {
         if (unit.face == Facing::LEFT) {
-            return unit.type->reverseImg[unit.team];
+            return unit.type->art->reverseImg[unit.team];
         }
-        return unit.type->baseImg[unit.team];
+        return unit.type->art->baseImg[unit.team];
     }
 
     // Restore the unit to the center of its hex and return to the base image.
@@ -131,19 +132,19 @@ void AnimMove::start()
 {
     auto &entity = bf_->getEntity(unit_.entityId);
     if (unit_.face == Facing::LEFT) {
-        if (!unit_.type->reverseImgMove.empty()) {
-            entity.img = unit_.type->reverseImgMove[unit_.team];
+        if (!unit_.type->art->reverseImgMove.empty()) {
+            entity.img = unit_.type->art->reverseImgMove[unit_.team];
         }
         else {
-            entity.img = unit_.type->reverseImg[unit_.team];
+            entity.img = unit_.type->art->reverseImg[unit_.team];
         }
     }
     else {
-        if (!unit_.type->imgMove.empty()) {
-            entity.img = unit_.type->imgMove[unit_.team];
+        if (!unit_.type->art->imgMove.empty()) {
+            entity.img = unit_.type->art->imgMove[unit_.team];
         }
         else {
-            entity.img = unit_.type->baseImg[unit_.team];
+            entity.img = unit_.type->art->baseImg[unit_.team];
         }
     }
     entity.z = ZOrder::ANIMATING;
@@ -159,8 +160,8 @@ void AnimMove::run(Uint32 elapsed)
     auto dhex = pixelFromHex(destHex_) - pixelFromHex(entity.hex);
     entity.pOffset = dhex * frac;
 
-    if (!soundPlayed_ && unit_.type->sndMove) {
-        sdlPlaySound(unit_.type->sndMove);
+    if (!soundPlayed_ && unit_.type->art->sndMove) {
+        sdlPlaySound(unit_.type->art->sndMove);
         soundPlayed_ = true;
     }
 }
@@ -230,25 +231,25 @@ void AnimAttack::setPosition(Uint32 elapsed)
 void AnimAttack::setFrame(Uint32 elapsed)
 {
     auto &entity = bf_->getEntity(unit_.entityId);
-    entity.frame = getFrame(unit_.type->attackFrames, elapsed);
+    entity.frame = getFrame(unit_.type->art->attackFrames, elapsed);
 
     if (unit_.face == Facing::LEFT) {
-        if (!unit_.type->reverseAnimAttack.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->reverseAnimAttack[unit_.team];
-            entity.numFrames = unit_.type->attackFrames.size();
+        if (!unit_.type->art->reverseAnimAttack.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->reverseAnimAttack[unit_.team];
+            entity.numFrames = unit_.type->art->attackFrames.size();
         }
         else {
-            entity.img = unit_.type->reverseImg[unit_.team];
+            entity.img = unit_.type->art->reverseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
     else {
-        if (!unit_.type->animAttack.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->animAttack[unit_.team];
-            entity.numFrames = unit_.type->attackFrames.size();
+        if (!unit_.type->art->animAttack.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->animAttack[unit_.team];
+            entity.numFrames = unit_.type->art->attackFrames.size();
         }
         else {
-            entity.img = unit_.type->baseImg[unit_.team];
+            entity.img = unit_.type->art->baseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
@@ -257,8 +258,8 @@ void AnimAttack::setFrame(Uint32 elapsed)
 void AnimAttack::playSound(Uint32 elapsed)
 {
     // TODO: magic number
-    if (!soundPlayed_ && unit_.type->sndAttack && elapsed > 100) {
-        sdlPlaySound(unit_.type->sndAttack);
+    if (!soundPlayed_ && unit_.type->art->sndAttack && elapsed > 100) {
+        sdlPlaySound(unit_.type->art->sndAttack);
         soundPlayed_ = true;
     }
 }
@@ -276,24 +277,24 @@ void AnimDefend::run(Uint32 elapsed)
 {
     auto &entity = bf_->getEntity(unit_.entityId);
     if (unit_.face == Facing::LEFT) {
-        if (elapsed >= hitTime_ && !unit_.type->reverseImgDefend.empty()) {
-            entity.img = unit_.type->reverseImgDefend[unit_.team];
+        if (elapsed >= hitTime_ && !unit_.type->art->reverseImgDefend.empty()) {
+            entity.img = unit_.type->art->reverseImgDefend[unit_.team];
         }
         else {
-            entity.img = unit_.type->reverseImg[unit_.team];
+            entity.img = unit_.type->art->reverseImg[unit_.team];
         }
     }
     else {
-        if (elapsed >= hitTime_ && !unit_.type->imgDefend.empty()) {
-            entity.img = unit_.type->imgDefend[unit_.team];
+        if (elapsed >= hitTime_ && !unit_.type->art->imgDefend.empty()) {
+            entity.img = unit_.type->art->imgDefend[unit_.team];
         }
         else {
-            entity.img = unit_.type->baseImg[unit_.team];
+            entity.img = unit_.type->art->baseImg[unit_.team];
         }
     }
 
-    if (!soundPlayed_ && unit_.type->sndDefend && elapsed >= hitTime_) {
-        sdlPlaySound(unit_.type->sndDefend);
+    if (!soundPlayed_ && unit_.type->art->sndDefend && elapsed >= hitTime_) {
+        sdlPlaySound(unit_.type->art->sndDefend);
         soundPlayed_ = true;
     }
 }
@@ -331,25 +332,25 @@ void AnimRanged::stop()
 void AnimRanged::setFrame(Uint32 elapsed)
 {
     auto &entity = bf_->getEntity(unit_.entityId);
-    entity.frame = getFrame(unit_.type->rangedFrames, elapsed);
+    entity.frame = getFrame(unit_.type->art->rangedFrames, elapsed);
 
     if (unit_.face == Facing::LEFT) {
-        if (!unit_.type->reverseAnimRanged.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->reverseAnimRanged[unit_.team];
-            entity.numFrames = unit_.type->rangedFrames.size();
+        if (!unit_.type->art->reverseAnimRanged.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->reverseAnimRanged[unit_.team];
+            entity.numFrames = unit_.type->art->rangedFrames.size();
         }
         else {
-            entity.img = unit_.type->reverseImg[unit_.team];
+            entity.img = unit_.type->art->reverseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
     else {
-        if (!unit_.type->animRanged.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->animRanged[unit_.team];
-            entity.numFrames = unit_.type->rangedFrames.size();
+        if (!unit_.type->art->animRanged.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->animRanged[unit_.team];
+            entity.numFrames = unit_.type->art->rangedFrames.size();
         }
         else {
-            entity.img = unit_.type->baseImg[unit_.team];
+            entity.img = unit_.type->art->baseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
@@ -360,8 +361,8 @@ void AnimRanged::playSound(Uint32 elapsed)
     // TODO: magic number
     Uint32 soundTime = getShotTime() - 150;
 
-    if (!soundPlayed_ && unit_.type->sndRanged && elapsed > soundTime) {
-        sdlPlaySound(unit_.type->sndRanged);
+    if (!soundPlayed_ && unit_.type->art->sndRanged && elapsed > soundTime) {
+        sdlPlaySound(unit_.type->art->sndRanged);
         soundPlayed_ = true;
     }
 }
@@ -422,9 +423,9 @@ AnimDie::AnimDie(Unit unit, Uint32 hitsAt)
     fadeTime_{hitsAt}
 {
     runTime_ = hitTime_ + fadeLength_;
-    if (!unit_.type->dieFrames.empty()) {
-        runTime_ += unit_.type->dieFrames.back();
-        fadeTime_ += unit_.type->dieFrames.back();
+    if (!unit_.type->art->dieFrames.empty()) {
+        runTime_ += unit_.type->art->dieFrames.back();
+        fadeTime_ += unit_.type->art->dieFrames.back();
     }
 }
 
@@ -438,8 +439,8 @@ void AnimDie::run(Uint32 elapsed)
     label.visible = false;
     setFrame(elapsed);
 
-    if (elapsed > hitTime_ && !soundPlayed_ && unit_.type->getDieSound()) {
-        sdlPlaySound(unit_.type->getDieSound());
+    if (elapsed > hitTime_ && !soundPlayed_ && unit_.type->art->getDieSound()) {
+        sdlPlaySound(unit_.type->art->getDieSound());
         soundPlayed_ = true;
     }
 
@@ -461,33 +462,33 @@ void AnimDie::stop()
 void AnimDie::setFrame(Uint32 elapsed)
 {
     auto &entity = bf_->getEntity(unit_.entityId);
-    entity.frame = getFrame(unit_.type->dieFrames, elapsed - hitTime_);
+    entity.frame = getFrame(unit_.type->art->dieFrames, elapsed - hitTime_);
 
     if (unit_.face == Facing::LEFT) {
-        if (!unit_.type->reverseAnimDie.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->reverseAnimDie[unit_.team];
-            entity.numFrames = unit_.type->dieFrames.size();
+        if (!unit_.type->art->reverseAnimDie.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->reverseAnimDie[unit_.team];
+            entity.numFrames = unit_.type->art->dieFrames.size();
         }
-        else if (!unit_.type->reverseImgDefend.empty()) {
-            entity.img = unit_.type->reverseImgDefend[unit_.team];
+        else if (!unit_.type->art->reverseImgDefend.empty()) {
+            entity.img = unit_.type->art->reverseImgDefend[unit_.team];
             entity.numFrames = 1;
         }
         else {
-            entity.img = unit_.type->reverseImg[unit_.team];
+            entity.img = unit_.type->art->reverseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
     else {
-        if (!unit_.type->animDie.empty() && entity.frame >= 0) {
-            entity.img = unit_.type->animDie[unit_.team];
-            entity.numFrames = unit_.type->dieFrames.size();
+        if (!unit_.type->art->animDie.empty() && entity.frame >= 0) {
+            entity.img = unit_.type->art->animDie[unit_.team];
+            entity.numFrames = unit_.type->art->dieFrames.size();
         }
-        else if (!unit_.type->imgDefend.empty()) {
-            entity.img = unit_.type->imgDefend[unit_.team];
+        else if (!unit_.type->art->imgDefend.empty()) {
+            entity.img = unit_.type->art->imgDefend[unit_.team];
             entity.numFrames = 1;
         }
         else {
-            entity.img = unit_.type->baseImg[unit_.team];
+            entity.img = unit_.type->art->baseImg[unit_.team];
             entity.numFrames = 1;
         }
     }
@@ -546,14 +547,15 @@ AnimEffect::AnimEffect(Effect e, Unit target, Point hex, Uint32 startsAt)
     hex_{std::move(hex)},
     startTime_{startsAt}
 {
-    const auto &frames = effect_.getFrames();
+    const auto &art = getEffectArt(effect_.type);
+    const auto &frames = art.animFrames;
     runTime_ = startTime_;
     if (!frames.empty()) {
         runTime_ += frames.back();
     }
 
-    if (effect_.getAnim()) {
-        id_ = bf_->addHiddenEntity(effect_.getAnim(), ZOrder::PROJECTILE);
+    if (art.anim) {
+        id_ = bf_->addHiddenEntity(art.anim, ZOrder::PROJECTILE);
         auto &entity = bf_->getEntity(id_);
         entity.hex = hex_;
         entity.frame = 0;
@@ -580,7 +582,7 @@ void AnimEffect::run(Uint32 elapsed)
 
 void AnimEffect::runEnraged(Uint32 timeSinceStart)
 {
-    const auto &frames = effect_.getFrames();
+    const auto &frames = getEffectArt(effect_.type).animFrames;
     if (frames.size() < 2) return;
 
     auto fadeInTime = frames[0];
@@ -603,13 +605,15 @@ void AnimEffect::runOther(Uint32 timeSinceStart)
 {
     auto &entity = bf_->getEntity(id_);
     entity.visible = true;
-    entity.frame = getFrame(effect_.getFrames(), timeSinceStart);
+    entity.frame = getFrame(getEffectArt(effect_.type).animFrames,
+                            timeSinceStart);
 }
 
 void AnimEffect::playSound()
 {
-    if (!soundPlayed_ && effect_.getSound()) {
-        sdlPlaySound(effect_.getSound());
+    const auto &sound = getEffectArt(effect_.type).sound;
+    if (!soundPlayed_ && sound) {
+        sdlPlaySound(sound);
         soundPlayed_ = true;
     }
 }
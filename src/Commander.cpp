@@ -15,7 +15,7 @@
 Commander::Commander()
     : name{"Captain"},
     alignment{"Neutral"},
-    portrait{sdlLoadImage("portrait-captain.png")},
+    portrait{"portrait-captain.png"},
     attack{0},
     defense{0}
 {
@@ -35,7 +35,7 @@ Commander::Commander(const rapidjson::Value &json)
         alignment = json["alignment"].GetString();
     }
     if (json.HasMember("portrait")) {
-        portrait = sdlLoadImage(json["portrait"].GetString());
+        portrait = json["portrait"].GetString();
     }
     if (json.HasMember("attack")) {
         attack = json["attack"].GetInt();
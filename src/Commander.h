@@ -13,8 +13,6 @@
 #ifndef COMMANDER_H
 #define COMMANDER_H
 
-#include "sdl_helper.h"
-
 #include "rapidjson/document.h"
 #include <string>
 
@@ -22,7 +20,7 @@ struct Commander
 {
     std::string name;
     std::string alignment;
-    SdlSurface portrait;
+    std::string portrait;  // image file, loaded by CommanderView
     int attack;
     int defense;
 
@@ -22,8 +22,16 @@ CommanderView::CommanderView(SDL_Rect dispArea, int team, const GameState &gs)
     team_{team},
     font_(sdlGetFont(FontType::MEDIUM)),
     displayArea_(std::move(dispArea)),
-    txtAlign_{team == 0 ? Justify::LEFT : Justify::RIGHT}
+    txtAlign_{team == 0 ? Justify::LEFT : Justify::RIGHT},
+    portrait_{}
 {
+    const auto &cmdr = gs_.getCommander(team_);
+    if (!cmdr.portrait.empty()) {
+        portrait_ = sdlLoadImage(cmdr.portrait);
+        if (portrait_ && txtAlign_ == Justify::RIGHT) {
+            portrait_ = sdlFlipH(portrait_);
+        }
+    }
 }
 
 void CommanderView::draw() const
@@ -34,13 +42,9 @@ void CommanderView::draw() const
 
     // Draw the portrait.
     auto imgHeight = 200;
-    if (cmdr.portrait) {
-        auto img = cmdr.portrait;
-        imgHeight = img->h;
-        if (txtAlign_ == Justify::RIGHT) {
-            img = sdlFlipH(img);
-        }
-        sdlBlit(img, displayArea_.x, displayArea_.y);
+    if (portrait_) {
+        imgHeight = portrait_->h;
+        sdlBlit(portrait_, displayArea_.x, displayArea_.y);
     }
 
     // Draw the name below it.
@@ -28,6 +28,7 @@ private:
     const SdlFont &font_;
     SDL_Rect displayArea_;
     Justify txtAlign_;
+    SdlSurface portrait_;
 };
 
 #endif
@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "EffectArt.h"
+#include <unordered_map>
+
+namespace
+{
+    std::unordered_map<int, EffectArt> cache;
+}
+
+
+EffectArt::EffectArt()
+    : anim{},
+    animFrames{},
+    sound{}
+{
+}
+
+EffectArt::EffectArt(const rapidjson::Value &json)
+    : EffectArt()
+{
+    if (json.HasMember("anim")) {
+        anim = sdlLoadImage(json["anim"].GetString());
+    }
+    if (json.HasMember("anim-frames")) {
+        animFrames = jsonListUnsigned(json["anim-frames"]);
+    }
+    if (json.HasMember("sound")) {
+        sound = sdlLoadSound(json["sound"].GetString());
+    }
+}
+
+
+bool initEffectArt(const char *filename)
+{
+    rapidjson::Document doc;
+    if (!jsonParse(filename, doc)) return false;
+
+    for (auto i = doc.MemberBegin(); i != doc.MemberEnd(); ++i) {
+        auto type = effectFromStr(i->name.GetString());
+        if (type == EffectType::NONE || !i->value.IsObject()) continue;
+
+        cache.emplace(static_cast<int>(type), EffectArt(i->value));
+    }
+
+    return true;
+}
+
+const EffectArt & getEffectArt(EffectType type)
+{
+    static const EffectArt noArt;
+
+    auto iter = cache.find(static_cast<int>(type));
+    if (iter == cache.end()) return noArt;
+    return iter->second;
+}
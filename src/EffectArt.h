@@ -0,0 +1,37 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef EFFECT_ART_H
+#define EFFECT_ART_H
+
+#include "Effects.h"
+#include "json_utils.h"
+#include "sdl_helper.h"
+
+// Animation and sound for one effect type.  Only the front end uses these.
+struct EffectArt
+{
+    SdlSurface anim;
+    FrameList animFrames;
+    SdlSound sound;
+
+    EffectArt();
+    EffectArt(const rapidjson::Value &json);
+};
+
+// Call this after SDL initialized and loadGameData().
+bool initEffectArt(const char *filename);
+
+// Return empty art for effect types without any.
+const EffectArt & getEffectArt(EffectType type);
+
+#endif
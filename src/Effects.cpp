@@ -42,21 +42,9 @@ namespace
 
 EffectData::EffectData(EffectType t, const rapidjson::Value &json)
     : type{t},
-    anim{},
-    animFrames{},
-    sound{},
     dur{Duration::INSTANT},
     text{}
 {
-    if (json.HasMember("anim")) {
-        anim = sdlLoadImage(json["anim"].GetString());
-    }
-    if (json.HasMember("anim-frames")) {
-        animFrames = jsonListUnsigned(json["anim-frames"]);
-    }
-    if (json.HasMember("sound")) {
-        sound = sdlLoadSound(json["sound"].GetString());
-    }
     if (json.HasMember("duration")) {
         const auto &durType = json["duration"].GetString();
         auto iter = allDurations.find(to_upper(durType));
@@ -141,24 +129,6 @@ Effect::Effect(const GameState &gs, const Action &action, EffectType t)
     *this = getData(t)->create(gs, action);
 }
 
-const SdlSurface & Effect::getAnim() const
-{
-    assert(type != EffectType::NONE);
-    return getData(type)->anim;
-}
-
-const FrameList & Effect::getFrames() const
-{
-    assert(type != EffectType::NONE);
-    return getData(type)->animFrames;
-}
-
-const SdlSound & Effect::getSound() const
-{
-    assert(type != EffectType::NONE);
-    return getData(type)->sound;
-}
-
 const std::string & Effect::getText() const
 {
     assert(type != EffectType::NONE);
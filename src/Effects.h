@@ -14,7 +14,6 @@
 #define EFFECTS_H
 
 #include "json_utils.h"
-#include "sdl_helper.h"
 
 #include <string>
 
@@ -62,9 +61,6 @@ struct Effect;
 struct EffectData
 {
     EffectType type;
-    SdlSurface anim;
-    FrameList animFrames;
-    SdlSound sound;
     Duration dur;
     std::string text;
 
@@ -103,9 +99,6 @@ struct Effect
     Effect();
     Effect(const GameState &gs, const Action &action, EffectType t);
 
-    const SdlSurface & getAnim() const;
-    const FrameList & getFrames() const;
-    const SdlSound & getSound() const;
     const std::string & getText() const;
     bool isDone() const;  // can we remove this effect from the unit?
 
@@ -114,7 +107,8 @@ struct Effect
 };
 
 
-// Call this after SDL initialized but before the game starts.
+// Call this before the game starts.  Images and sounds for each effect are
+// loaded separately (see EffectArt).
 bool initEffectCache(const char *filename);
 
 // Return the effect type given by 'str' if possible, otherwise NONE.
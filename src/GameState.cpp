@@ -13,6 +13,7 @@
 #include "GameState.h"
 
 #include "Action.h"
+#include "ActionGenerator.h"
 #include "Effects.h"
 #include "HexGrid.h"
 #include "Pathfinder.h"
@@ -22,6 +23,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <ostream>
 
 namespace
@@ -29,10 +31,45 @@ namespace
     Unit nullUnit;
     const int ROUNDS_TO_DRAW = 4;
 
+    // Most chance outcomes the AI searches for one attack.
+    const unsigned MAX_DAMAGE_OUTCOMES = 4;
+
     void nullExecFunc(Action)
     {
         assert(false);
     }
+
+    // True if 'val' survives narrowing to T, as PackedState does.
+    template <typename T>
+    bool fitsIn(int val)
+    {
+        return val == static_cast<T>(val);
+    }
+
+    // Zobrist key for one unit.  Every field that can change during a battle
+    // feeds the key, entity id covers the ones that can't.
+    uint64_t unitKey(const Unit &u)
+    {
+        uint64_t key = hashMix(u.entityId);
+        key = hashMix(key ^ u.aHex);
+        key = hashMix(key ^ u.num);
+        key = hashMix(key ^ u.hpLeft);
+        key = hashMix(key ^ u.retaliated);
+        key = hashMix(key ^ static_cast<uint64_t>(u.effect.type));
+        key = hashMix(key ^ u.effect.roundsLeft);
+        key = hashMix(key ^ u.effect.data1);
+        return hashMix(key ^ u.effect.data2);
+    }
+
+    // Normalize each unit by comparing size to growth rate.
+    int unitScore(const Unit &u)
+    {
+        if (!u.isAlive()) return 0;
+
+        int score = (u.num - 1) * 100 / u.type->growth;
+        score += ceil((100.0 * u.hpLeft / u.type->hp) / u.type->growth);
+        return score;
+    }
 }
 
 std::vector<Commander> GameState::commanders_;
@@ -40,17 +77,29 @@ std::vector<Commander> GameState::commanders_;
 GameState::GameState(const HexGrid &bfGrid)
     : grid_(bfGrid),
     units_{},
+    unitSlot_{},
     turnOrder_{},
     curTurn_{-1},
     unitAtPos_(grid_.size(), -1),
+    occupied_(),
     roundNum_{0},
     execFunc_{nullExecFunc},
     simMode_{false},
+    simRollDamage_{false},
     drawTimer_{ROUNDS_TO_DRAW},
     mana_(2, 0),
-    manaLeft_(2, 0)
+    manaLeft_(2, 0),
+    unitsHash_{0},
+    turnOrderHash_{0},
+    teamScore_(),
+    undoDepth_{0},
+    unitJournal_{},
+    turnOrderJournal_{}
 {
+    assert(grid_.size() <= MAX_MASK_HEXES);
     commanders_.resize(2);
+    occupied_.fill(0);
+    teamScore_.fill(0);
 }
 
 void GameState::nextTurn()
@@ -90,12 +139,25 @@ int GameState::getActiveTeam() const
 void GameState::addUnit(Unit u)
 {
     assert(unitAtPos_[u.aHex] == -1);
+    assert(u.entityId == static_cast<int16_t>(u.entityId));  // see Action
 
-    int id = u.entityId;
-    unitAtPos_[u.aHex] = id;
+    if (u.isAlive()) {
+        setUnitAt(u.aHex, u);
+    }
+    unitsHash_ ^= unitKey(u);
+    assert(u.team >= 0 && u.team < static_cast<int>(teamScore_.size()));
+    teamScore_[u.team] += unitScore(u);
     units_.emplace_back(std::move(u));
     stable_sort(std::begin(units_), std::end(units_),
         [] (const Unit &a, const Unit &b) { return a.entityId < b.entityId; });
+
+    // Entity ids are small and nearly dense, so index them directly.  The
+    // search looks units up by id constantly.
+    assert(units_.back().entityId >= 0);
+    unitSlot_.assign(units_.back().entityId + 1, -1);
+    for (auto i = 0u; i < units_.size(); ++i) {
+        unitSlot_[units_[i].entityId] = i;
+    }
 }
 
 Unit & GameState::getUnit(int id)
@@ -105,11 +167,11 @@ Unit & GameState::getUnit(int id)
 
 const Unit & GameState::getUnit(int id) const
 {
-    auto iter = lower_bound(std::begin(units_), std::end(units_), id,
-        [] (const Unit &a, int b) { return a.entityId < b; });
-    if (iter == units_.end() || iter->entityId != id) return nullUnit;
+    if (id < 0 || id >= static_cast<int>(unitSlot_.size())) return nullUnit;
 
-    return *iter;
+    int slot = unitSlot_[id];
+    if (slot == -1) return nullUnit;
+    return units_[slot];
 }
 
 Unit & GameState::getActiveUnit()
@@ -141,7 +203,7 @@ const Unit & GameState::getUnitAt(int aIndex) const
 bool GameState::isHexOpen(int aIndex) const
 {
     if (grid_.offGrid(aIndex)) return false;
-    return !getUnitAt(aIndex).isAlive();
+    return ((occupied_[0] | occupied_[1]) & hexBit(aIndex)) == 0;
 }
 
 bool GameState::isHexFlyable(const Unit &unit, int aIndex) const
@@ -165,9 +227,13 @@ void GameState::moveUnit(int id, int aDest)
     auto &unit = getUnit(id);
     assert(unit.isValid());
 
-    unitAtPos_[unit.aHex] = -1;
-    unitAtPos_[aDest] = unit.entityId;
+    beginUnitChange(unit);
+    if (unit.isAlive()) {
+        clearUnitAt(unit.aHex, unit);
+        setUnitAt(aDest, unit);
+    }
     unit.aHex = aDest;
+    endUnitChange(unit);
 }
 
 int GameState::assignDamage(int id, int damage)
@@ -175,9 +241,11 @@ int GameState::assignDamage(int id, int damage)
     auto &unit = getUnit(id);
     assert(unit.isValid());
 
+    beginUnitChange(unit);
     int numKilled = unit.takeDamage(damage);
+    endUnitChange(unit);
     if (!unit.isAlive()) {
-        unitAtPos_[unit.aHex] = -1;
+        clearUnitAt(unit.aHex, unit);
     }
     if (numKilled > 0) {
         drawTimer_ = ROUNDS_TO_DRAW;
@@ -197,6 +265,10 @@ std::vector<int> GameState::getAdjEnemies(int id, int aIndex) const
     const auto &unit = getUnit(id);
     if (!unit.isAlive()) return {};
 
+    // Check the whole neighborhood at once, most hexes don't have any.
+    auto enemyMask = occupied_[1 - unit.team];
+    if ((grid_.aryNeighborMask(aIndex) & enemyMask) == 0) return {};
+
     std::vector<int> enemies;
 
     for (auto n : grid_.aryNeighbors(aIndex)) {
@@ -227,20 +299,42 @@ std::vector<int> GameState::getAllEnemies(int id) const
 
 std::array<int, 2> GameState::getScore() const
 {
-    std::array<int, 2> score;
-    score.fill(0);
+    if (drawTimer_ <= 0) return {{0, 0}};
+    return teamScore_;
+}
 
-    if (drawTimer_ <= 0) return score;
+std::array<int, 2> GameState::getMaxScore() const
+{
+    int numCreatures = 0;
+    for (const auto &u : units_) {
+        if (u.isAlive()) numCreatures += u.num;
+    }
 
+    // A stack scores at most num * 100 / growth, plus 1 for rounding up the
+    // top creature (see unitScore()).
+    std::array<int, 2> maxScore = {{0, 0}};
+    std::array<int, 2> zombieGrowth = {{0, 0}};
     for (const auto &u : units_) {
         if (!u.isAlive()) continue;
 
-        assert(u.team >= 0 && u.team < static_cast<int>(score.size()));
-        int unitScore = (u.num - 1) * 100 / u.type->growth;
-        unitScore += ceil((100.0 * u.hpLeft / u.type->hp) / u.type->growth);
-        score[u.team] += unitScore;
+        maxScore[u.team] += u.num * 100 / u.type->growth + 1;
+        if (u.hasTrait(Trait::ZOMBIFY)) {
+            auto &growth = zombieGrowth[u.team];
+            growth = (growth == 0) ? u.type->growth :
+                std::min(growth, u.type->growth);
+            ++maxScore[u.team];  // rounding on the creatures it gains
+        }
+    }
+
+    // Any creature on the battlefield might end up in a side's cheapest
+    // zombifying stack.
+    for (int t = 0; t < 2; ++t) {
+        if (zombieGrowth[t] > 0) {
+            maxScore[t] += numCreatures * 100 / zombieGrowth[t];
+        }
     }
-    return score;
+
+    return maxScore;
 }
 
 bool GameState::isGameOver() const
@@ -298,7 +392,11 @@ bool GameState::canUseRangedAttack(int attId) const
     if (!att.isAlive()) return false;
     if (att.hasTrait(Trait::SPELLCASTER)) return false;
 
-    return getAdjEnemies(attId).empty() && att.hasTrait(Trait::RANGED);
+    if (!att.hasTrait(Trait::RANGED)) return false;
+
+    // No adjacent enemies.
+    auto enemyMask = occupied_[1 - att.team];
+    return (grid_.aryNeighborMask(att.aHex) & enemyMask) == 0;
 }
 
 bool GameState::isRangedAttackAllowed(int attId, int defId) const
@@ -416,10 +514,10 @@ std::vector<int> GameState::getPath(int aSrc, int aTgt) const
 {
     if (grid_.offGrid(aSrc) || grid_.offGrid(aTgt)) return {};
 
-    Pathfinder pf;
-    pf.setNeighbors([&] (int aIndex) {return getOpenNeighbors(aIndex);});
-    pf.setGoal(aTgt);
-    return pf.getPathFrom(aSrc);
+    auto pf = makePathfinder(grid_.size(), [this] (int aIndex, NodeList &nbrs) {
+        getOpenNeighbors(aIndex, nbrs);
+    });
+    return pf.getPathFrom(aSrc, aTgt);
 }
 
 std::vector<int> GameState::getPath(const Unit &unit, int aTgt) const
@@ -440,66 +538,106 @@ std::vector<int> GameState::getPath(const Unit &unit, int aTgt) const
 
 Action GameState::makeMove(int id, int aTgt) const
 {
+    Action action;
+    makeMove(id, aTgt, action);
+    return action;
+}
+
+Action GameState::makeAttack(int attId, int defId, int aMoveTgt) const
+{
+    Action action;
+    makeAttack(attId, defId, aMoveTgt, action);
+    return action;
+}
+
+Action GameState::makeSkip(int id) const
+{
+    Action action;
+    makeSkip(id, action);
+    return action;
+}
+
+void GameState::makeMove(int id, int aTgt, Action &action,
+                         const ReachableSet *reachable) const
+{
+    action.reset();
+
     const auto &unit = getUnit(id);
-    if (!unit.isAlive()) return {};
+    if (!unit.isAlive()) return;
 
-    auto path = getPath(unit, aTgt);
-    if (path.size() <= 1 || path.size() > unit.getMaxPathSize()) {
-        return {};
+    getPath(unit, aTgt, reachable, action.path);
+    if (action.path.size() <= 1 ||
+        action.path.size() > unit.getMaxPathSize())
+    {
+        action.path.clear();
+        return;
     }
 
-    Action action;
     action.type = ActionType::MOVE;
+    assert(id == static_cast<int16_t>(id));
     action.attacker = id;
-    action.path = path;
-    return action;
 }
 
-Action GameState::makeAttack(int attId, int defId, int aMoveTgt) const
+void GameState::makeAttack(int attId, int defId, int aMoveTgt,
+                           Action &action, const ReachableSet *reachable) const
 {
+    action.reset();
+
     const auto &attacker = getUnit(attId);
     const auto &defender = getUnit(defId);
-    if (!attacker.isAlive() || !defender.isAlive()) return {};
+    if (!attacker.isAlive() || !defender.isAlive()) return;
 
-    Action action;
-    action.attacker = attId;
-    action.defender = defId;
-    action.aTgt = defender.aHex;
+    // Actions store these in narrower types.
+    assert(attId == static_cast<int16_t>(attId));
+    assert(defId == static_cast<int16_t>(defId));
+    assert(defender.aHex == static_cast<int8_t>(defender.aHex));
 
     bool attMoved = (aMoveTgt != attacker.aHex);
 
     if (!attMoved && isRangedAttackAllowed(attId, defId)) {
         action.type = ActionType::RANGED;
-        return action;
+        action.attacker = attId;
+        action.defender = defId;
+        action.aTgt = defender.aHex;
+        return;
     }
     if (!attMoved && isSpellAllowed(attId, defId)) {
         action.type = ActionType::EFFECT;
+        action.attacker = attId;
+        action.defender = defId;
+        action.aTgt = defender.aHex;
         action.damage = attacker.num * attacker.type->spell->damage;
         action.effect = Effect(*this, action, attacker.type->spell->effect);
+        assert(attacker.type->spell->cost ==
+               static_cast<int8_t>(attacker.type->spell->cost));
         action.manaCost = attacker.type->spell->cost;
-        return action;
+        return;
     }
 
     bool isAdjacent = contains(grid_.aryNeighbors(aMoveTgt), defender.aHex);
     if (!isAdjacent || !isMeleeAttackAllowed(attId, defId)) {
-        return {};
+        return;
     }
 
-    auto path = getPath(attacker, aMoveTgt);
-    if (path.empty() || path.size() > attacker.getMaxPathSize()) {
-        return {};
+    getPath(attacker, aMoveTgt, reachable, action.path);
+    if (action.path.empty() ||
+        action.path.size() > attacker.getMaxPathSize())
+    {
+        action.path.clear();
+        return;
     }
     action.type = ActionType::ATTACK;
-    action.path = path;
-    return action;
+    action.attacker = attId;
+    action.defender = defId;
+    action.aTgt = defender.aHex;
 }
 
-Action GameState::makeSkip(int id) const
+void GameState::makeSkip(int id, Action &action) const
 {
-    Action action;
+    action.reset();
     action.type = ActionType::NONE;
+    assert(id == static_cast<int16_t>(id));
     action.attacker = id;
-    return action;
 }
 
 Action GameState::makeRetaliation(const Action &action) const
@@ -544,7 +682,9 @@ int GameState::computeDamage(const Action &action) const
 
     // Spells and traits have already computed damage.
     if (action.type != ActionType::EFFECT) {
-        if (simMode_) {
+        if (simMode_ && action.fixedDamage) return damage;
+
+        if (simMode_ && !simRollDamage_) {
             damage = att.num * att.avgDamage(action.type);
         }
         else {
@@ -562,6 +702,128 @@ int GameState::computeDamage(const Action &action) const
     return damage;
 }
 
+std::vector<GameState::DamageOutcome> GameState::getDamageDistribution(
+    const Action &action) const
+{
+    std::vector<DamageOutcome> outcomes;
+    if (action.type != ActionType::ATTACK &&
+        action.type != ActionType::RANGED)
+    {
+        return outcomes;
+    }
+    if (isFirstStrikeAllowed(action)) return outcomes;
+
+    const auto &att = getUnit(action.attacker);
+    const auto &def = getUnit(action.defender);
+    auto roll = att.damageRoll(action.type);
+    double probRoll = 1.0 / (roll.second - roll.first + 1);
+    double multiplier = getDamageMultiplier(action);
+    int enraged = att.hasEffect(EffectType::ENRAGED) ? 2 : 1;
+
+    // Rolls in the current result, to average their damage.
+    int damageSum = 0;
+    int numRolls = 0;
+
+    for (int r = roll.first; r <= roll.second; ++r) {
+        // Same arithmetic as computeDamage().  Every creature in the stack
+        // shares one roll.
+        int damage = att.num * r * enraged;
+        damage *= multiplier;
+
+        // More damage never leaves the defender better off, so rolls with
+        // the same result are next to each other.
+        auto result = def.damageResult(damage);
+        if (!outcomes.empty() && outcomes.back().kills == result.first &&
+            outcomes.back().hpLeft == result.second)
+        {
+            outcomes.back().probability += probRoll;
+        }
+        else {
+            DamageOutcome outcome;
+            outcome.damage = damage;
+            outcome.kills = result.first;
+            outcome.hpLeft = result.second;
+            outcome.probability = probRoll;
+            outcomes.push_back(outcome);
+            damageSum = 0;
+            numRolls = 0;
+        }
+
+        // Anything between the least and most damage for the same result
+        // also produces it.
+        damageSum += damage;
+        ++numRolls;
+        outcomes.back().damage = std::lround(static_cast<double>(damageSum) /
+                                             numRolls);
+    }
+
+    return outcomes;
+}
+
+std::vector<GameState::DamageOutcome> GameState::getDamageOutcomes(
+    const Action &action) const
+{
+    auto results = getDamageDistribution(action);
+    std::vector<DamageOutcome> outcomes;
+    if (results.empty()) return outcomes;
+
+    // Results come in order of increasing damage, so each kill count is a run
+    // of consecutive results.  Remember where each one ends and how likely it
+    // is.
+    std::vector<unsigned> groupEnds;
+    std::vector<double> groupProbs;
+    for (auto i = 0u; i < results.size(); ++i) {
+        if (i > 0 && results[i].kills == results[i - 1].kills) {
+            groupEnds.back() = i + 1;
+            groupProbs.back() += results[i].probability;
+        }
+        else {
+            groupEnds.push_back(i + 1);
+            groupProbs.push_back(results[i].probability);
+        }
+    }
+
+    // A wide damage range against a big stack can kill any of a dozen or more
+    // different numbers of creatures.  Keep the search from branching that
+    // far by merging the least likely pair of neighboring groups until few
+    // enough are left.
+    while (groupEnds.size() > MAX_DAMAGE_OUTCOMES) {
+        auto merge = 0u;
+        for (auto i = 1u; i < groupEnds.size() - 1; ++i) {
+            if (groupProbs[i] + groupProbs[i + 1] <
+                groupProbs[merge] + groupProbs[merge + 1])
+            {
+                merge = i;
+            }
+        }
+        groupProbs[merge + 1] += groupProbs[merge];
+        groupEnds.erase(std::begin(groupEnds) + merge);
+        groupProbs.erase(std::begin(groupProbs) + merge);
+    }
+
+    // Each group deals the mean damage of its rolls.  A merged group can span
+    // several kill counts, so work out the result of that damage again.
+    const auto &def = getUnit(action.defender);
+    auto groupStart = 0u;
+    for (auto i = 0u; i < groupEnds.size(); ++i) {
+        double damage = 0.0;
+        for (auto j = groupStart; j < groupEnds[i]; ++j) {
+            damage += results[j].damage * results[j].probability;
+        }
+
+        DamageOutcome outcome;
+        outcome.damage = std::lround(damage / groupProbs[i]);
+        auto result = def.damageResult(outcome.damage);
+        outcome.kills = result.first;
+        outcome.hpLeft = result.second;
+        outcome.probability = groupProbs[i];
+        outcomes.push_back(outcome);
+        groupStart = groupEnds[i];
+    }
+
+    return outcomes;
+}
+
 void GameState::execute(const Action &action)
 {
     if (action.type == ActionType::NONE) return;
@@ -582,12 +844,14 @@ void GameState::execute(const Action &action)
         assert(def.isAlive());
         auto numKilled = assignDamage(action.defender, action.damage);
 
+        beginUnitChange(att);
         if (att.hasTrait(Trait::LIFE_DRAIN)) {
             att.hpLeft = std::min(att.hpLeft + action.damage, att.type->hp);
         }
         if (att.hasTrait(Trait::ZOMBIFY)) {
             att.num += numKilled;
         }
+        endUnitChange(att);
     }
     else if (action.type == ActionType::EFFECT) {
         assert(def.isAlive());
@@ -596,7 +860,9 @@ void GameState::execute(const Action &action)
         auto effect = action.effect;
         if (!effect.isDone()) {
             // Effects with duration stay with the defending unit.
+            beginUnitChange(def);
             def.effect = effect;
+            endUnitChange(def);
         }
 
         assignDamage(action.defender, action.damage);
@@ -606,48 +872,20 @@ void GameState::execute(const Action &action)
     if (action.type == ActionType::RETALIATE &&
         !att.hasTrait(Trait::STEADFAST))
     {
+        beginUnitChange(att);
         att.retaliated = true;
+        endUnitChange(att);
     }
 }
 
 std::vector<Action> GameState::getPossibleActions() const
 {
-    const auto &unit = getActiveUnit();
-    assert(unit.isAlive());
-
-    auto reachableHexes = getReachableHexes(unit);
     std::vector<Action> actions;
-
-    if (canUseRangedAttack(unit.entityId)) {
-        for (auto e : getAllEnemies(unit.entityId)) {
-            actions.push_back(makeAttack(unit.entityId, e, unit.aHex));
-        }
-    }
-    else if (canUseSpell(unit.entityId)) {
-        for (const auto &target : units_) {
-            if (!target.isAlive()) continue;
-            auto possible = makeAttack(unit.entityId, target.entityId,
-                                       unit.aHex);
-            if (possible.type == ActionType::NONE) continue;
-            actions.push_back(std::move(possible));
-        }
-    }
-    else if (canUseMeleeAttack(unit.entityId)) {
-        for (auto aHex : reachableHexes) {
-            for (auto e : getAdjEnemies(unit.entityId, aHex)) {
-                actions.push_back(makeAttack(unit.entityId, e, aHex));
-            }
-        }
-    }
-
-    actions.emplace_back(makeSkip(unit.entityId));
-
-    for (auto aHex : reachableHexes) {
-        if (aHex != unit.aHex) {
-            actions.emplace_back(makeMove(unit.entityId, aHex));
-        }
+    ActionGenerator gen{*this};
+    Action action;
+    while (gen.next(action)) {
+        actions.push_back(action);
     }
-
     return actions;
 }
 
@@ -701,9 +939,10 @@ void GameState::setExecFunc(std::function<void (Action)> f)
     execFunc_ = std::move(f);
 }
 
-void GameState::setSimMode()
+void GameState::setSimMode(bool rollDamage)
 {
     simMode_ = true;
+    simRollDamage_ = rollDamage;
 }
 
 void GameState::runActionSeq(Action action)
@@ -770,8 +1009,174 @@ int GameState::getManaLeft(int team) const
     return manaLeft_[team];
 }
 
+GameState::Undo GameState::applyTurn(const Action &action)
+{
+    Undo undo;
+    undo.unitJournalSize = unitJournal_.size();
+    undo.turnOrderJournalSize = turnOrderJournal_.size();
+    undo.curTurn = curTurn_;
+    undo.roundNum = roundNum_;
+    undo.drawTimer = drawTimer_;
+    copy(std::begin(mana_), std::end(mana_), std::begin(undo.mana));
+    copy(std::begin(manaLeft_), std::end(manaLeft_), std::begin(undo.manaLeft));
+    undo.unitsHash = unitsHash_;
+    undo.turnOrderHash = turnOrderHash_;
+    undo.teamScore = teamScore_;
+
+    ++undoDepth_;
+    runActionSeq(action);
+    nextTurn();
+    return undo;
+}
+
+void GameState::undoTurn(const Undo &undo)
+{
+    assert(undoDepth_ > 0);
+    assert(unitJournal_.size() >= undo.unitJournalSize);
+    assert(turnOrderJournal_.size() >= undo.turnOrderJournalSize);
+
+    // Restore units newest change first, moving each one back on the map.
+    while (unitJournal_.size() > undo.unitJournalSize) {
+        const auto &change = unitJournal_.back();
+        auto &unit = units_[change.first];
+        if (unit.isAlive() && unitAtPos_[unit.aHex] == unit.entityId) {
+            clearUnitAt(unit.aHex, unit);
+        }
+        unit = change.second;
+        if (unit.isAlive()) {
+            setUnitAt(unit.aHex, unit);
+        }
+        unitJournal_.pop_back();
+    }
+
+    while (turnOrderJournal_.size() > undo.turnOrderJournalSize) {
+        int size = turnOrderJournal_.back();
+        turnOrderJournal_.pop_back();
+        auto first = std::end(turnOrderJournal_) - size;
+        turnOrder_.assign(first, std::end(turnOrderJournal_));
+        turnOrderJournal_.erase(first, std::end(turnOrderJournal_));
+    }
+
+    curTurn_ = undo.curTurn;
+    roundNum_ = undo.roundNum;
+    drawTimer_ = undo.drawTimer;
+    copy(std::begin(undo.mana), std::end(undo.mana), std::begin(mana_));
+    copy(std::begin(undo.manaLeft), std::end(undo.manaLeft),
+         std::begin(manaLeft_));
+    unitsHash_ = undo.unitsHash;
+    turnOrderHash_ = undo.turnOrderHash;
+    teamScore_ = undo.teamScore;
+    --undoDepth_;
+}
+
+PackedState GameState::pack() const
+{
+    assert(units_.size() <= MAX_UNITS);
+    assert(turnOrder_.size() <= MAX_UNITS);
+
+    PackedState ps;
+    ps.numUnits = units_.size();
+    for (auto i = 0u; i < units_.size(); ++i) {
+        const auto &unit = units_[i];
+        assert(fitsIn<int16_t>(unit.num));
+        assert(fitsIn<int16_t>(unit.hpLeft));
+        assert(fitsIn<int16_t>(unit.effect.data1));
+        assert(fitsIn<int8_t>(unit.aHex));
+        assert(fitsIn<int8_t>(static_cast<int>(unit.effect.type)));
+        assert(fitsIn<int8_t>(unit.effect.roundsLeft));
+        assert(fitsIn<int8_t>(unit.effect.data2));
+
+        auto &pu = ps.units[i];
+        pu.num = unit.num;
+        pu.hpLeft = unit.hpLeft;
+        pu.effectData1 = unit.effect.data1;
+        pu.aHex = unit.aHex;
+        pu.effectType = static_cast<int8_t>(unit.effect.type);
+        pu.effectRoundsLeft = unit.effect.roundsLeft;
+        pu.effectData2 = unit.effect.data2;
+        pu.retaliated = unit.retaliated;
+    }
+
+    ps.turnOrderSize = turnOrder_.size();
+    for (auto i = 0u; i < turnOrder_.size(); ++i) {
+        ps.turnOrder[i] = &getUnit(turnOrder_[i]) - units_.data();
+    }
+
+    assert(fitsIn<int8_t>(curTurn_));
+    assert(fitsIn<int8_t>(drawTimer_));
+    assert(fitsIn<int16_t>(roundNum_));
+    ps.curTurn = curTurn_;
+    ps.drawTimer = drawTimer_;
+    ps.roundNum = roundNum_;
+    for (int team = 0; team < 2; ++team) {
+        assert(fitsIn<int16_t>(mana_[team]));
+        assert(fitsIn<int16_t>(manaLeft_[team]));
+        ps.mana[team] = mana_[team];
+        ps.manaLeft[team] = manaLeft_[team];
+    }
+    ps.unitsHash = unitsHash_;
+    ps.turnOrderHash = turnOrderHash_;
+    return ps;
+}
+
+void GameState::unpack(const PackedState &ps)
+{
+    assert(ps.numUnits == static_cast<int>(units_.size()));
+    assert(undoDepth_ == 0);
+
+    teamScore_.fill(0);
+    for (auto i = 0u; i < units_.size(); ++i) {
+        auto &unit = units_[i];
+        const auto &pu = ps.units[i];
+        unit.num = pu.num;
+        unit.hpLeft = pu.hpLeft;
+        unit.effect.data1 = pu.effectData1;
+        unit.aHex = pu.aHex;
+        unit.effect.type = static_cast<EffectType>(pu.effectType);
+        unit.effect.roundsLeft = pu.effectRoundsLeft;
+        unit.effect.data2 = pu.effectData2;
+        unit.retaliated = pu.retaliated;
+        teamScore_[unit.team] += unitScore(unit);
+    }
+
+    turnOrder_.clear();
+    for (int i = 0; i < ps.turnOrderSize; ++i) {
+        turnOrder_.push_back(units_[ps.turnOrder[i]].entityId);
+    }
+
+    curTurn_ = ps.curTurn;
+    drawTimer_ = ps.drawTimer;
+    roundNum_ = ps.roundNum;
+    for (int team = 0; team < 2; ++team) {
+        mana_[team] = ps.mana[team];
+        manaLeft_[team] = ps.manaLeft[team];
+    }
+    unitsHash_ = ps.unitsHash;
+    turnOrderHash_ = ps.turnOrderHash;
+
+    remapUnitPos();
+}
+
+uint64_t GameState::getHash() const
+{
+    uint64_t turnKey = hashMix(turnOrderHash_ ^ curTurn_);
+    turnKey = hashMix(turnKey ^ drawTimer_);
+    for (int team = 0; team < 2; ++team) {
+        turnKey = hashMix(turnKey ^ mana_[team]);
+        turnKey = hashMix(turnKey ^ manaLeft_[team]);
+    }
+
+    return unitsHash_ ^ turnKey;
+}
+
 void GameState::nextRound()
 {
+    if (undoDepth_ > 0) {
+        turnOrderJournal_.insert(std::end(turnOrderJournal_),
+                                 std::begin(turnOrder_), std::end(turnOrder_));
+        turnOrderJournal_.push_back(turnOrder_.size());
+    }
+
     turnOrder_.clear();
     for (const auto &u : units_) {
         if (u.isAlive()) {
@@ -786,8 +1191,15 @@ void GameState::nextRound()
     stable_sort(std::begin(turnOrder_), std::end(turnOrder_), sortByInitiative);
     alternateTeamInitiative();
 
-    for_each(std::begin(turnOrder_), std::end(turnOrder_),
-             [this] (int id) {getUnit(id).retaliated = false;});
+    turnOrderHash_ = 0;
+    for (auto id : turnOrder_) {
+        auto &unit = getUnit(id);
+        beginUnitChange(unit);
+        unit.retaliated = false;
+        endUnitChange(unit);
+
+        turnOrderHash_ = hashMix(turnOrderHash_ ^ id);
+    }
 
     remapUnitPos();
 
@@ -803,14 +1215,29 @@ void GameState::nextRound()
 void GameState::remapUnitPos()
 {
     fill(std::begin(unitAtPos_), std::end(unitAtPos_), -1);
+    occupied_.fill(0);
 
     for (const auto &unit : units_) {
         if (unit.isAlive()) {
-            unitAtPos_[unit.aHex] = unit.entityId;
+            setUnitAt(unit.aHex, unit);
         }
     }
 }
 
+void GameState::setUnitAt(int aIndex, const Unit &unit)
+{
+    assert(unit.team == 0 || unit.team == 1);
+    unitAtPos_[aIndex] = unit.entityId;
+    occupied_[unit.team] |= hexBit(aIndex);
+}
+
+void GameState::clearUnitAt(int aIndex, const Unit &unit)
+{
+    assert(unitAtPos_[aIndex] == unit.entityId);
+    unitAtPos_[aIndex] = -1;
+    occupied_[unit.team] &= ~hexBit(aIndex);
+}
+
 void GameState::alternateTeamInitiative()
 {
     int size = turnOrder_.size();
@@ -871,36 +1298,66 @@ double GameState::getDamageMultiplier(const Action &action) const
     return attackBonus;
 }
 
-std::vector<int> GameState::getOpenNeighbors(int aIndex) const
+void GameState::getOpenNeighbors(int aIndex, NodeList &nbrs) const
 {
-    std::vector<int> nbrs;
+    auto occupied = occupied_[0] | occupied_[1];
     for (auto n : grid_.aryNeighbors(aIndex)) {
-        if (isHexOpen(n)) {
+        if ((occupied & hexBit(n)) == 0) {
             nbrs.push_back(n);
         }
     }
-    return nbrs;
 }
 
-std::vector<int> GameState::getReachableHexes(const Unit &unit) const
+ReachableSet GameState::getReachable(const Unit &unit) const
 {
-    std::vector<int> reachable;
-
     // Flying units don't need a clear path.
     if (unit.canFly()) {
+        ReachableSet reachable;
         for (int i = 0; i < grid_.size(); ++i) {
             if (isHexFlyable(unit, i)) {
-                reachable.push_back(i);
+                reachable.entries.push_back({i, -1, -1});
             }
         }
+        return reachable;
     }
-    else {
-        Pathfinder pf;
-        pf.setNeighbors([&] (int aIndex) {return getOpenNeighbors(aIndex);});
-        reachable = pf.getReachableNodes(unit.aHex, unit.type->moves);
+
+    auto pf = makePathfinder(grid_.size(), [this] (int aIndex, NodeList &nbrs) {
+        getOpenNeighbors(aIndex, nbrs);
+    });
+    return pf.getReachable(unit.aHex, unit.type->moves);
+}
+
+void GameState::getPath(const Unit &unit, int aTgt,
+                        const ReachableSet *reachable, ActionPath &path) const
+{
+    path.clear();
+
+    // Anything a search from the unit's hex didn't reach is too far away to
+    // be a legal action, whether or not there's a longer path to it.
+    if (reachable && !isHexFlyable(unit, aTgt)) {
+        auto entry = reachable->find(aTgt);
+        if (!entry || entry->dist < 0) return;
+
+        // Walk back to the unit's hex, then fill in the path from there.
+        // Every step costs 1, so the distance is the number of steps.
+        int size = entry->dist + 1;
+        if (size > ActionPath::MAX_SIZE) return;
+
+        int hexes[ActionPath::MAX_SIZE];
+        int i = size;
+        for (; entry; entry = reachable->find(entry->prev)) {
+            assert(i > 0);
+            hexes[--i] = entry->node;
+        }
+        assert(i == 0);
+        path.assign(hexes, hexes + size);
+        return;
     }
 
-    return reachable;
+    auto fullPath = getPath(unit, aTgt);
+    if (fullPath.size() <= ActionPath::MAX_SIZE) {
+        path.assign(std::begin(fullPath), std::end(fullPath));
+    }
 }
 
 void GameState::simulate(Action action)
@@ -933,9 +1390,29 @@ void GameState::onStartTurn()
     }
 
     if (unit.effect.type != EffectType::NONE) {
+        beginUnitChange(unit);
         unit.effect.apply(*this, unit);
         if (unit.effect.isDone()) {
             unit.effect = Effect();
         }
+        endUnitChange(unit);
     }
 }
+
+void GameState::beginUnitChange(const Unit &unit)
+{
+    unitsHash_ ^= unitKey(unit);
+    teamScore_[unit.team] -= unitScore(unit);
+
+    if (undoDepth_ > 0) {
+        int index = &unit - units_.data();
+        assert(index >= 0 && index < static_cast<int>(units_.size()));
+        unitJournal_.emplace_back(index, unit);
+    }
+}
+
+void GameState::endUnitChange(const Unit &unit)
+{
+    unitsHash_ ^= unitKey(unit);
+    teamScore_[unit.team] += unitScore(unit);
+}
@@ -14,16 +14,21 @@
 #define GAME_STATE_H
 
 #include "Commander.h"
+#include "HexGrid.h"
+#include "PackedState.h"
 #include "Unit.h"
-#include "sdl_helper.h"
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <utility>
 #include <vector>
 
 class Action;
-class HexGrid;
+class ActionPath;
+class NodeList;
+struct ReachableSet;
 
 class GameState
 {
@@ -34,7 +39,9 @@ public:
     int getRound() const;
     int getActiveTeam() const;
 
-    // Units are owned by their GameState instance.
+    // Units are owned by their GameState instance.  Only change cosmetic fields
+    // (like facing) through the non-const accessors, or else the position hash
+    // goes stale.
     void addUnit(Unit u);
     Unit & getUnit(int id);
     const Unit & getUnit(int id) const;
@@ -59,8 +66,14 @@ public:
     std::vector<int> getAllEnemies(int id) const;
 
     // Score the current battle state for each side.  Normalize each unit by
-    // comparing size to growth rate.
+    // comparing size to growth rate.  Kept up to date as units change, so
+    // this is cheap enough to call at every search node.
     std::array<int, 2> getScore() const;
+
+    // Upper bound on the score each side could reach from here.  Creatures
+    // are never created, but Zombify can move them into a stack that's worth
+    // more per creature.
+    std::array<int, 2> getMaxScore() const;
     bool isGameOver() const;
     bool isActiveTeamWinning() const;
 
@@ -87,14 +100,51 @@ public:
     Action makeMove(int id, int aTgt) const;
     Action makeAttack(int attId, int defId, int aMoveTgt) const;
     Action makeSkip(int id) const;
+
+    // Same as above, but overwrite an existing action.  If the unit's
+    // reachable hexes are given (see getReachable()), paths come from there
+    // instead of a new search for each action.
+    void makeMove(int id, int aTgt, Action &action,
+                  const ReachableSet *reachable = nullptr) const;
+    void makeAttack(int attId, int defId, int aMoveTgt, Action &action,
+                    const ReachableSet *reachable = nullptr) const;
+    void makeSkip(int id, Action &action) const;
     Action makeRetaliation(const Action &action) const;
     Action makeRegeneration(int id) const;
     Action makeBind(int attId, int defId) const;
 
+    // In sim mode, an attack with 'fixedDamage' set uses its damage as is
+    // instead of the average (see getDamageOutcomes()).
     int computeDamage(const Action &action) const;
     void execute(const Action &action);
 
-    // Generate the set of all possible actions for the active unit.
+    // What an attack might do to the defender: damage dealt, creatures
+    // killed, and hp of the defender's top creature afterward.
+    struct DamageOutcome
+    {
+        int damage;
+        int kills;
+        int hpLeft;
+        double probability;
+    };
+
+    // Exact distribution of an attack's effect on the defender, including the
+    // commander multiplier and Enraged, one entry per distinct result in
+    // order of increasing damage.  Each entry's damage is the average of the
+    // rolls that produce it.  Empty if the damage doesn't depend on a roll we can model
+    // up front (First Strike might shrink the attacker before it attacks).
+    std::vector<DamageOutcome> getDamageDistribution(
+        const Action &action) const;
+
+    // Same results, grouped by how many creatures the defender would lose,
+    // for the AI to search as chance nodes.  Neighboring groups are merged to
+    // keep the number small.  Each group deals the probability-weighted mean
+    // damage of its rolls, so anything that scales with damage dealt (like
+    // Life Drain) isn't biased by the merging.
+    std::vector<DamageOutcome> getDamageOutcomes(const Action &action) const;
+
+    // Generate the set of all possible actions for the active unit.  See
+    // ActionGenerator to produce them one at a time.
     std::vector<Action> getPossibleActions() const;
 
     void printAction(std::ostream &ostr, const Action &action) const;
@@ -104,8 +154,9 @@ public:
     void setExecFunc(std::function<void (Action)> f);
 
     // Use simulated damage for all actions.  Execute actions internally only.
-    // Do not use the callback function.
-    void setSimMode();
+    // Do not use the callback function.  Damage is the average roll unless
+    // 'rollDamage' is set, in which case it's random like the real game.
+    void setSimMode(bool rollDamage = false);
 
     // Encapsulate running an action and any retaliations or other special
     // abilities.  Runs the action callback for the given action and every
@@ -118,13 +169,53 @@ public:
     int getMana(int team) const;
     int getManaLeft(int team) const;
 
+    // Record of what applyTurn() changed, enough to restore the previous
+    // state.  Unit changes are kept in a journal inside the GameState, so
+    // this stays small.
+    struct Undo
+    {
+        unsigned unitJournalSize;
+        unsigned turnOrderJournalSize;
+        int curTurn;
+        int roundNum;
+        int drawTimer;
+        std::array<int, 2> mana;
+        std::array<int, 2> manaLeft;
+        uint64_t unitsHash;
+        uint64_t turnOrderHash;
+        std::array<int, 2> teamScore;
+    };
+
+    // Same as runActionSeq() followed by nextTurn(), but remember everything
+    // that changed so the AI can walk back up the search tree without
+    // copying the GameState.  Undo in the reverse order of applying.
+    Undo applyTurn(const Action &action);
+    void undoTurn(const Undo &undo);
+
+    // Convert the changing parts of the battle to and from a compact form.
+    // Unpacking requires the same set of units that packed it.
+    PackedState pack() const;
+    void unpack(const PackedState &ps);
+
+    // Zobrist hash of everything that affects the outcome of the battle from
+    // here: unit positions, sizes, hit points, retaliations, effects, mana,
+    // and whose turn it is.  Unit state is hashed incrementally as it changes.
+    uint64_t getHash() const;
+
 private:
+    friend class ActionGenerator;
+
     void nextRound();
 
     // Rebuild the mapping of unit positions.  Call this whenever 'units_' is
     // invalidated.
     void remapUnitPos();
 
+    // Change the mapping of unit positions one hex at a time, keeping the
+    // occupancy masks in step.
+    void setUnitAt(int aIndex, const Unit &unit);
+    void clearUnitAt(int aIndex, const Unit &unit);
+
     // When units tie for initiative, make sure we alternate teams.
     void alternateTeamInitiative();
     void alternateTeams(int turnOrderBegin, int turnOrderEnd);
@@ -134,10 +225,16 @@ private:
     double getDamageMultiplier(const Action &action) const;
 
     // Get list of neighboring hexes that are free of units.
-    std::vector<int> getOpenNeighbors(int aIndex) const;
+    void getOpenNeighbors(int aIndex, NodeList &nbrs) const;
+
+    // Get list of all hexes the given unit can reach that are free of units,
+    // and the paths to get there.  Flying units don't need a path, so they
+    // only get the list.
+    ReachableSet getReachable(const Unit &unit) const;
 
-    // Get list of all hexes the given unit can reach that are free of units.
-    std::vector<int> getReachableHexes(const Unit &unit) const;
+    // Path the unit would take to the given hex, empty if it can't get there.
+    void getPath(const Unit &unit, int aTgt, const ReachableSet *reachable,
+                 ActionPath &path) const;
 
     // Use simulated damage when executing actions.
     void simulate(Action action);
@@ -145,17 +242,31 @@ private:
     void actionCallback(Action action);
     void onStartTurn();
 
+    // Call these before and after any change to a unit's state to keep the
+    // position hash and team scores current and the undo journal complete.
+    void beginUnitChange(const Unit &unit);
+    void endUnitChange(const Unit &unit);
+
     const HexGrid &grid_;
-    std::vector<Unit> units_;
+    std::vector<Unit> units_;  // sorted by entity id
+    std::vector<int> unitSlot_;  // entity id -> index into 'units_', or -1
     std::vector<int> turnOrder_;
     int curTurn_;
     std::vector<int> unitAtPos_;
+    std::array<HexMask, 2> occupied_;  // hexes holding a live unit, by team
     int roundNum_;
     std::function<void (Action)> execFunc_;
     bool simMode_;
+    bool simRollDamage_;
     int drawTimer_;  // stalemate if no units killed several rounds in a row
     std::vector<int> mana_;
     std::vector<int> manaLeft_;
+    uint64_t unitsHash_;
+    uint64_t turnOrderHash_;
+    std::array<int, 2> teamScore_;  // before the draw rule is applied
+    int undoDepth_;  // number of applyTurn() calls not yet undone
+    std::vector<std::pair<int, Unit>> unitJournal_;  // index, prior state
+    std::vector<int> turnOrderJournal_;  // prior turn order, then its size
     static std::vector<Commander> commanders_;
 };
 
@@ -18,13 +18,29 @@
 #include <limits>
 #include <random>
 
+namespace
+{
+    const int NUM_DIRS = 6;
+
+    // All-pairs distances take size^2 entries, skip them past this size.
+    const int MAX_DIST_TABLE_HEXES = 1024;
+
+    const HexNeighbors noNeighbors;
+}
+
 HexGrid::HexGrid(int width, int height)
     : width_{width},
     height_{height},
     size_{width_ * height_},
-    invalidHexes_{}
+    erased_(size_, false),
+    neighborDir_{},
+    neighbors_{},
+    neighborMasks_{},
+    dist_{}
 {
     assert(width_ > 0 && height_ > 0);
+    buildNeighbors();
+    buildDistances();
 }
 
 int HexGrid::width() const
@@ -95,13 +111,16 @@ Point HexGrid::hexRandom() const
 
 int HexGrid::aryDist(int aSrc, int aTgt) const
 {
+    if (!dist_.empty() && !offGrid(aSrc) && !offGrid(aTgt)) {
+        return dist_[aSrc * size_ + aTgt];
+    }
     return hexDist(hexFromAry(aSrc), hexFromAry(aTgt));
 }
 
 int HexGrid::aryGetNeighbor(int aSrc, Dir d) const
 {
-    auto neighbor = adjacent(hexFromAry(aSrc), d);
-    return aryFromHex(neighbor);
+    if (offGrid(aSrc)) return -1;
+    return neighborDir_[aSrc * NUM_DIRS + static_cast<int>(d)];
 }
 
 Point HexGrid::hexGetNeighbor(const Point &hSrc, Dir d) const
@@ -114,19 +133,17 @@ Point HexGrid::hexGetNeighbor(const Point &hSrc, Dir d) const
     return neighbor;
 }
 
-std::vector<int> HexGrid::aryNeighbors(int aIndex) const
+const HexNeighbors & HexGrid::aryNeighbors(int aIndex) const
 {
-    if (offGrid(aIndex)) return {};
-
-    std::vector<int> av;
-    for (auto d : Dir()) {
-        auto aNeighbor = aryGetNeighbor(aIndex, d);
-        if (aNeighbor != -1) {
-            av.push_back(aNeighbor);
-        }
-    }
+    if (offGrid(aIndex)) return noNeighbors;
+    return neighbors_[aIndex];
+}
 
-    return av;
+HexMask HexGrid::aryNeighborMask(int aIndex) const
+{
+    assert(size_ <= MAX_MASK_HEXES);
+    if (offGrid(aIndex)) return 0;
+    return neighborMasks_[aIndex];
 }
 
 std::vector<Point> HexGrid::hexNeighbors(const Point &hex) const
@@ -143,24 +160,23 @@ std::vector<Point> HexGrid::hexNeighbors(const Point &hex) const
 void HexGrid::erase(int hx, int hy)
 {
     int aIndex = aryFromHexImpl({hx, hy});
-    invalidHexes_.push_back(aIndex);
-    sort(std::begin(invalidHexes_), std::end(invalidHexes_));
+    assert(aIndex >= 0 && aIndex < size_);
+    erased_[aIndex] = true;
+    buildNeighbors();
 }
 
 bool HexGrid::offGrid(const Point &hex) const
 {
-    if (wasErased(aryFromHexImpl(hex))) return true;
-
-    return hex.x < 0 ||
-           hex.y < 0 ||
-           hex.x >= width_ ||
-           hex.y >= height_;
+    if (hex.x < 0 || hex.y < 0 || hex.x >= width_ || hex.y >= height_) {
+        return true;
+    }
+    return wasErased(aryFromHexImpl(hex));
 }
 
 bool HexGrid::offGrid(int aIndex) const
 {
-    if (wasErased(aIndex)) return true;
-    return aIndex < 0 || aIndex >= size_;
+    if (aIndex < 0 || aIndex >= size_) return true;
+    return wasErased(aIndex);
 }
 
 Point HexGrid::hexFromAryImpl(int aIndex) const
@@ -175,6 +191,45 @@ int HexGrid::aryFromHexImpl(const Point &hex) const
 
 bool HexGrid::wasErased(int aIndex) const
 {
-    return binary_search(std::begin(invalidHexes_), std::end(invalidHexes_),
-                         aIndex);
+    return erased_[aIndex];
+}
+
+void HexGrid::buildNeighbors()
+{
+    neighborDir_.assign(size_ * NUM_DIRS, -1);
+    neighbors_.assign(size_, HexNeighbors());
+    if (size_ <= MAX_MASK_HEXES) {
+        neighborMasks_.assign(size_, 0);
+    }
+
+    for (int aIndex = 0; aIndex < size_; ++aIndex) {
+        if (offGrid(aIndex)) continue;
+
+        auto hex = hexFromAryImpl(aIndex);
+        for (auto d : Dir()) {
+            auto aNeighbor = aryFromHex(adjacent(hex, d));
+            neighborDir_[aIndex * NUM_DIRS + static_cast<int>(d)] = aNeighbor;
+            if (aNeighbor != -1) {
+                neighbors_[aIndex].push_back(aNeighbor);
+                if (!neighborMasks_.empty()) {
+                    neighborMasks_[aIndex] |= hexBit(aNeighbor);
+                }
+            }
+        }
+    }
+}
+
+void HexGrid::buildDistances()
+{
+    // Erasing hexes doesn't change the distance between the rest, so this
+    // only has to happen once.
+    if (size_ > MAX_DIST_TABLE_HEXES) return;
+
+    dist_.resize(size_ * size_);
+    for (int aSrc = 0; aSrc < size_; ++aSrc) {
+        auto hSrc = hexFromAryImpl(aSrc);
+        for (int aTgt = 0; aTgt < size_; ++aTgt) {
+            dist_[aSrc * size_ + aTgt] = hexDist(hSrc, hexFromAryImpl(aTgt));
+        }
+    }
 }
@@ -14,8 +14,37 @@
 #define HEX_GRID_H
 
 #include "hex_utils.h"
+#include <cstdint>
 #include <vector>
 
+// Set of hexes on a grid of up to 64 hexes, bit i for array index i.
+typedef uint64_t HexMask;
+const int MAX_MASK_HEXES = 64;
+
+inline HexMask hexBit(int aIndex)
+{
+    return HexMask{1} << aIndex;
+}
+
+// Neighbors of one hex, in direction order starting from north.
+class HexNeighbors
+{
+public:
+    HexNeighbors() : hexes_(), size_{0} {}
+
+    void push_back(int aIndex) {hexes_[size_++] = aIndex;}
+    int size() const {return size_;}
+    bool empty() const {return size_ == 0;}
+    const int * begin() const {return hexes_;}
+    const int * end() const {return hexes_ + size_;}
+
+private:
+    int hexes_[6];
+    int size_;
+};
+
+// Neighbors and distances between hexes are looked up in tables built when
+// the grid is created or changed, since the AI asks for them constantly.
 class HexGrid
 {
 public:
@@ -47,7 +76,10 @@ public:
     Point hexGetNeighbor(const Point &hSrc, Dir d) const;
 
     // Compute all neighbors of a given hex.  Might have fewer than 6.
-    std::vector<int> aryNeighbors(int aIndex) const;
+    const HexNeighbors & aryNeighbors(int aIndex) const;
+
+    // Same as a bit mask.  Only for grids of up to MAX_MASK_HEXES.
+    HexMask aryNeighborMask(int aIndex) const;
     std::vector<Point> hexNeighbors(const Point &hex) const;
 
     // Erase a hex to create an irregular map.
@@ -65,10 +97,17 @@ private:
     // Return true if the given hex is in the set of erased hexes.
     bool wasErased(int aIndex) const;
 
+    void buildNeighbors();
+    void buildDistances();
+
     int width_;
     int height_;
     int size_;
-    std::vector<int> invalidHexes_;
+    std::vector<bool> erased_;
+    std::vector<int> neighborDir_;  // size_ * 6, -1 if off the map
+    std::vector<HexNeighbors> neighbors_;
+    std::vector<HexMask> neighborMasks_;  // empty if the grid is too big
+    std::vector<int16_t> dist_;  // size_ * size_, empty if the grid is huge
 };
 
 #endif
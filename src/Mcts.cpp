@@ -0,0 +1,267 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "Mcts.h"
+
+#include "GameState.h"
+#include "algo.h"
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    // UCT exploration constant.  Results are in [0, 1], so the usual
+    // 1/sqrt(2) balances exploration and exploitation.
+    const double EXPLORATION = 0.7071;
+
+    // Stop adding nodes once a tree takes about this much memory.  The cap
+    // is per tree, not per process.  Melee units can have 50 actions per
+    // node, so this is on the order of 20-50k nodes.
+    const size_t MAX_TREE_BYTES = 128 * 1024 * 1024;
+
+    // Rough overhead of one entry in the node index.
+    const size_t INDEX_ENTRY_BYTES = sizeof(std::pair<uint64_t, int>) +
+        2 * sizeof(void *);
+
+    // Safety valve in case a playout wanders.  The draw timer normally ends
+    // the battle well before this.
+    const int MAX_PLAYOUT_TURNS = 500;
+
+    // Selection can revisit a position by transposition, so also bound how
+    // far down the tree one pass goes.
+    const int MAX_TREE_DEPTH = 200;
+}
+
+MctsTree::MctsTree()
+    : nodes_{},
+    nodeIndex_{},
+    root_{-1},
+    bytesUsed_{0}
+{
+}
+
+void MctsTree::setRoot(const GameState &gs)
+{
+    auto iter = nodeIndex_.find(gs.getHash());
+    if (iter == std::end(nodeIndex_)) {
+        // Nothing to reuse, so give all the memory back instead of keeping
+        // the capacity around.
+        std::vector<Node>().swap(nodes_);
+        std::unordered_map<uint64_t, int>().swap(nodeIndex_);
+        bytesUsed_ = 0;
+        root_ = findOrAddNode(gs);
+        return;
+    }
+
+    // Keep only the nodes reachable from the new root.  Positions that can't
+    // happen anymore would just take up space.
+    std::vector<Node> kept;
+    std::unordered_map<uint64_t, int> keptIndex;
+    keptIndex.emplace(iter->first, 0);
+    kept.push_back(std::move(nodes_[iter->second]));
+
+    // Careful, adding to 'kept' can move the node we're looking at.
+    for (auto i = 0u; i < kept.size(); ++i) {
+        for (auto e = 0u; e < kept[i].edges.size(); ++e) {
+            for (auto c = 0u; c < kept[i].edges[e].children.size(); ++c) {
+                int child = kept[i].edges[e].children[c];
+                auto hash = nodes_[child].hash;
+                auto keptIter = keptIndex.find(hash);
+                if (keptIter == std::end(keptIndex)) {
+                    keptIter = keptIndex.emplace(hash, kept.size()).first;
+                    kept.push_back(std::move(nodes_[child]));
+                }
+                kept[i].edges[e].children[c] = keptIter->second;
+            }
+        }
+    }
+
+    nodes_.swap(kept);
+    nodeIndex_.swap(keptIndex);
+    root_ = 0;
+
+    bytesUsed_ = 0;
+    for (const auto &node : nodes_) {
+        bytesUsed_ += getNodeBytes(node);
+    }
+}
+
+void MctsTree::runPlayout(const GameState &root)
+{
+    assert(root_ >= 0 && nodes_[root_].hash == root.getHash());
+
+    GameState gs{root};
+    std::vector<std::pair<int, int>> path;  // node, edge index
+    int n = root_;
+    double result = 0.0;
+
+    // Select actions down the tree until we reach a position we haven't seen
+    // before.  Add it to the tree and finish the battle from there.
+    for (int depth = 0; ; ++depth) {
+        if (nodes_[n].team < 0) {
+            result = getResult(gs);
+            break;
+        }
+        if (depth >= MAX_TREE_DEPTH) {
+            result = playout(gs);
+            break;
+        }
+
+        int e = selectEdge(nodes_[n]);
+        path.emplace_back(n, e);
+        gs.runActionSeq(nodes_[n].edges[e].action);
+        gs.nextTurn();
+
+        bool isNew = (nodeIndex_.find(gs.getHash()) == std::end(nodeIndex_));
+        if (isNew && bytesUsed_ >= MAX_TREE_BYTES) {
+            result = playout(gs);
+            break;
+        }
+
+        int child = findOrAddNode(gs);
+        auto &children = nodes_[n].edges[e].children;
+        if (!contains(children, child)) {
+            children.push_back(child);
+            bytesUsed_ += sizeof(int);
+        }
+        n = child;
+
+        if (isNew) {
+            result = (nodes_[n].team < 0) ? getResult(gs) : playout(gs);
+            break;
+        }
+    }
+
+    for (const auto &step : path) {
+        auto &node = nodes_[step.first];
+        auto &edge = node.edges[step.second];
+        ++node.visits;
+        ++edge.visits;
+        edge.value += (node.team == 0) ? result : 1.0 - result;
+    }
+}
+
+Action MctsTree::getBestAction() const
+{
+    assert(root_ >= 0 && !nodes_[root_].edges.empty());
+
+    const auto &edges = nodes_[root_].edges;
+    auto best = max_element(std::begin(edges), std::end(edges),
+                            [] (const Edge &lhs, const Edge &rhs) {
+                                return lhs.visits < rhs.visits;
+                            });
+    return best->action;
+}
+
+int MctsTree::getRootVisits() const
+{
+    assert(root_ >= 0);
+    return nodes_[root_].visits;
+}
+
+int MctsTree::findOrAddNode(const GameState &gs)
+{
+    auto hash = gs.getHash();
+    auto iter = nodeIndex_.find(hash);
+    if (iter != std::end(nodeIndex_)) return iter->second;
+
+    Node node;
+    node.hash = hash;
+    node.team = -1;
+    node.visits = 0;
+    if (!gs.isGameOver()) {
+        node.team = gs.getActiveTeam();
+        for (auto &action : gs.getPossibleActions()) {
+            Edge edge;
+            edge.action = std::move(action);
+            edge.visits = 0;
+            edge.value = 0.0;
+            node.edges.push_back(std::move(edge));
+        }
+    }
+
+    int index = nodes_.size();
+    bytesUsed_ += getNodeBytes(node);
+    nodes_.push_back(std::move(node));
+    nodeIndex_.emplace(hash, index);
+    return index;
+}
+
+size_t MctsTree::getNodeBytes(const Node &node)
+{
+    size_t bytes = sizeof(Node) + INDEX_ENTRY_BYTES +
+        node.edges.capacity() * sizeof(Edge);
+    for (const auto &edge : node.edges) {
+        bytes += edge.children.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+// Try every action once, in the order they were generated (attacks first).
+// After that, balance the best results so far against actions we haven't
+// tried as often.
+int MctsTree::selectEdge(const Node &node) const
+{
+    assert(!node.edges.empty());
+
+    int best = 0;
+    double bestScore = -1.0;
+    double logVisits = log(std::max(node.visits, 1));
+    for (auto i = 0u; i < node.edges.size(); ++i) {
+        const auto &edge = node.edges[i];
+        if (edge.visits == 0) return i;
+
+        double score = edge.value / edge.visits +
+            EXPLORATION * sqrt(logVisits / edge.visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Attack whenever possible, otherwise do anything.  Purely random playouts
+// spend most of their time walking around.
+double MctsTree::playout(GameState &gs) const
+{
+    for (int t = 0; t < MAX_PLAYOUT_TURNS && !gs.isGameOver(); ++t) {
+        auto actions = gs.getPossibleActions();
+        std::vector<Action> attacks;
+        for (auto &action : actions) {
+            if (action.type != ActionType::NONE &&
+                action.type != ActionType::MOVE)
+            {
+                attacks.push_back(action);
+            }
+        }
+
+        if (!attacks.empty()) {
+            gs.runActionSeq(*randomElem(attacks));
+        }
+        else {
+            gs.runActionSeq(*randomElem(actions));
+        }
+        gs.nextTurn();
+    }
+
+    return getResult(gs);
+}
+
+// Win or loss if the battle is over, otherwise the share of the total score.
+double MctsTree::getResult(const GameState &gs)
+{
+    auto score = gs.getScore();
+    if (score[0] == 0 && score[1] == 0) return 0.5;
+    return static_cast<double>(score[0]) / (score[0] + score[1]);
+}
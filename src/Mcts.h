@@ -0,0 +1,80 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "Action.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class GameState;
+
+// Monte Carlo Tree Search using UCT.  Each node is a position, identified by
+// its hash, so different damage rolls after the same action lead to different
+// nodes.  Playouts use real random damage, so the game state given to the
+// tree must be in sim mode with damage rolls turned on.  Each tree stops
+// growing at about 128MB, so every player with its own tree can use that
+// much.
+class MctsTree
+{
+public:
+    MctsTree();
+
+    // Start searching from the given position.  Keep what we already know
+    // about it if it's somewhere in the tree from an earlier search.
+    void setRoot(const GameState &gs);
+
+    // Run one selection/expansion/playout/backup pass from the root.
+    void runPlayout(const GameState &root);
+
+    // Most visited action at the root.
+    Action getBestAction() const;
+    int getRootVisits() const;
+
+private:
+    struct Edge
+    {
+        Action action;
+        int visits;
+        double value;  // sum of playout results for the team taking the action
+        std::vector<int> children;  // every position seen after the action
+    };
+
+    struct Node
+    {
+        uint64_t hash;
+        int team;  // active team, -1 if the battle is over
+        int visits;
+        std::vector<Edge> edges;
+    };
+
+    int findOrAddNode(const GameState &gs);
+
+    // Approximate memory taken by one node, its edges, and its index entry.
+    static size_t getNodeBytes(const Node &node);
+    int selectEdge(const Node &node) const;
+
+    // Finish the battle with a simple policy and return the result for
+    // team 0, from 0 (loss) to 1 (win).
+    double playout(GameState &gs) const;
+    static double getResult(const GameState &gs);
+
+    std::vector<Node> nodes_;
+    std::unordered_map<uint64_t, int> nodeIndex_;
+    int root_;
+    size_t bytesUsed_;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef PACKED_STATE_H
+#define PACKED_STATE_H
+
+#include <cstdint>
+#include <type_traits>
+
+// Most units one battle can hold, one per starting position on the
+// battlefield (see unitPos in battle.cpp).
+const int MAX_UNITS = 14;
+
+// Fixed-size, heap-free snapshot of everything in a GameState that changes
+// during a battle.  Copying one is a single memcpy, so AI code can store them
+// in tables and queues.  Units are stored in the same order as the GameState
+// that packed them, and only that GameState (or a copy) can unpack them.
+struct PackedState
+{
+    struct PackedUnit
+    {
+        int16_t num;
+        int16_t hpLeft;
+        int16_t effectData1;
+        int8_t aHex;
+        int8_t effectType;
+        int8_t effectRoundsLeft;
+        int8_t effectData2;
+        bool retaliated;
+    };
+
+    PackedUnit units[MAX_UNITS];
+    int8_t turnOrder[MAX_UNITS];  // indexes into 'units'
+    int8_t numUnits;
+    int8_t turnOrderSize;
+    int8_t curTurn;
+    int8_t drawTimer;
+    int16_t roundNum;
+    int16_t mana[2];
+    int16_t manaLeft[2];
+    uint64_t unitsHash;
+    uint64_t turnOrderHash;
+};
+
+static_assert(std::is_trivial<PackedState>::value,
+              "PackedState must be copyable with memcpy");
+
+#endif
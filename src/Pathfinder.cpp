@@ -12,10 +12,11 @@
 */
 #include "Pathfinder.h"
 #include "algo.h"
+#include "boost/thread/tss.hpp"
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <memory>
-#include <queue>
 #include <unordered_map>
 #include <vector>
 
@@ -29,12 +30,6 @@ struct AstarNode
 
 typedef std::shared_ptr<AstarNode> AstarNodePtr;
 
-struct BfsNode
-{
-    int id;
-    int costSoFar;
-};
-
 namespace {
     AstarNodePtr make_astar_node(int prev, int costSoFar, int estTotalCost)
     {
@@ -42,13 +37,172 @@ namespace {
         return std::make_shared<AstarNode>(AstarNode{prev, costSoFar,
                                                      estTotalCost, visited});
     }
+
+    boost::thread_specific_ptr<AstarNodes> threadNodes;
+
+    // Neighbors of a node in a graph given as functions.  There's no limit
+    // on how many a node can have, unlike NodeList.
+    struct NeighborVector
+    {
+        std::vector<int> nodes;
+
+        void push_back(int node) {nodes.push_back(node);}
+        std::vector<int>::const_iterator begin() const {return nodes.begin();}
+        std::vector<int>::const_iterator end() const {return nodes.end();}
+    };
+
+    // Adapt a Pathfinder's functions for BasicPathfinder.  They hold
+    // pointers, so setting up a search doesn't copy any std::functions.
+    struct NeighborList
+    {
+        const std::function<std::vector<int> (int)> *func;
+
+        void operator()(int n, NeighborVector &nbrs) const
+        {
+            nbrs.nodes = (*func)(n);
+        }
+    };
+
+    struct StepCostRef
+    {
+        const std::function<int (int, int)> *func;
+
+        int operator()(int a, int b) const {return (*func)(a, b);}
+    };
+
+    struct EstimateRef
+    {
+        const std::function<int (int)> *func;
+
+        int operator()(int n) const {return (*func)(n);}
+    };
+
+    using FunctionPathfinder = BasicPathfinder<NeighborList, StepCostRef,
+                                               EstimateRef, NeighborVector>;
+}
+
+AstarNodes::AstarNodes()
+    : nodes_{},
+    open_{},
+    generation_{0}
+{
+}
+
+AstarNodes & AstarNodes::startSearch(int numNodes)
+{
+    // The AI searches on several threads at once.
+    if (!threadNodes.get()) {
+        threadNodes.reset(new AstarNodes);
+    }
+    threadNodes->start(numNodes);
+    return *threadNodes;
+}
+
+AstarNodes::Node * AstarNodes::find(int n)
+{
+    auto &node = nodes_[n];
+    return (node.generation == generation_) ? &node : nullptr;
+}
+
+AstarNodes::Node & AstarNodes::get(int n)
+{
+    return nodes_[n];
+}
+
+void AstarNodes::add(int n, int prev, int costSoFar, int estTotalCost)
+{
+    nodes_[n] = Node{prev, costSoFar, estTotalCost, generation_,
+                     static_cast<int>(open_.size())};
+    open_.push_back(n);
+    siftUp(open_.size() - 1);
+}
+
+void AstarNodes::decreaseKey(int n)
+{
+    assert(nodes_[n].heapPos >= 0);
+    siftUp(nodes_[n].heapPos);
+}
+
+bool AstarNodes::empty() const
+{
+    return open_.empty();
+}
+
+int AstarNodes::pop()
+{
+    int top = open_.front();
+    nodes_[top].heapPos = -1;
+    int last = open_.back();
+    open_.pop_back();
+    if (!open_.empty()) {
+        place(last, 0);
+        siftDown(0);
+    }
+    return top;
+}
+
+void AstarNodes::start(int numNodes)
+{
+    if (static_cast<int>(nodes_.size()) < numNodes) {
+        nodes_.resize(numNodes, Node{-1, 0, 0, 0, -1});
+    }
+    open_.clear();
+    ++generation_;
+    if (generation_ == 0) {
+        for (auto &node : nodes_) {
+            node.generation = 0;
+        }
+        generation_ = 1;
+    }
+}
+
+int AstarNodes::cost(int pos) const
+{
+    return nodes_[open_[pos]].estTotalCost;
+}
+
+void AstarNodes::place(int n, int pos)
+{
+    open_[pos] = n;
+    nodes_[n].heapPos = pos;
+}
+
+void AstarNodes::siftUp(int pos)
+{
+    int n = open_[pos];
+    int nCost = nodes_[n].estTotalCost;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (cost(parent) <= nCost) break;
+        place(open_[parent], pos);
+        pos = parent;
+    }
+    place(n, pos);
+}
+
+void AstarNodes::siftDown(int pos)
+{
+    int n = open_[pos];
+    int nCost = nodes_[n].estTotalCost;
+    int size = open_.size();
+    while (2 * pos + 1 < size) {
+        int child = 2 * pos + 1;
+        if (child + 1 < size && cost(child + 1) < cost(child)) {
+            ++child;
+        }
+        if (nCost <= cost(child)) break;
+        place(open_[child], pos);
+        pos = child;
+    }
+    place(n, pos);
 }
 
 Pathfinder::Pathfinder()
     : neighbors_{[] (int) { return std::vector<int>(); }},
     goal_{[] (int) { return false; }},
     stepCost_{[] (int, int) { return 1; }},
-    estimate_{[] (int) { return 0; }}
+    estimate_{[] (int) { return 0; }},
+    numNodes_{0}
 {
 }
 
@@ -77,9 +231,20 @@ void Pathfinder::setEstimate(std::function<int (int)> func)
     estimate_ = func;
 }
 
+void Pathfinder::setNumNodes(int numNodes)
+{
+    assert(numNodes >= 0);
+    numNodes_ = numNodes;
+}
+
 std::vector<int> Pathfinder::getPathFrom(int start) const
 {
     if (goal_(start)) return {start};
+    if (numNodes_ > 0) {
+        FunctionPathfinder pf{numNodes_, NeighborList{&neighbors_},
+                              StepCostRef{&stepCost_}, EstimateRef{&estimate_}};
+        return pf.getPathFrom(start, goal_);
+    }
 
     // Record shortest path costs for every node we examine.
     std::unordered_map<int, AstarNodePtr> nodes;
@@ -159,30 +324,47 @@ std::vector<int> Pathfinder::getPathFrom(int start) const
 
 std::vector<int> Pathfinder::getReachableNodes(int start, int maxDist) const
 {
-    std::queue<BfsNode> nodeQ;
-    std::vector<int> reachable;
+    if (numNodes_ > 0) {
+        std::vector<int> reachable;
+        for (const auto &entry : getReachable(start, maxDist).entries) {
+            reachable.push_back(entry.node);
+        }
+        return reachable;
+    }
 
-    nodeQ.emplace(BfsNode{start, 0});
+    // Without a node range, remember the shortest distance to each node in
+    // a hash table and only search onward from a node when that improves.
+    std::unordered_map<int, int> dist;
+    std::deque<int> nodeQ;
+    dist.emplace(start, 0);
+    nodeQ.push_back(start);
 
     while (!nodeQ.empty()) {
-        const auto &node = nodeQ.front();
-        if (binary_search(std::begin(reachable), std::end(reachable), node.id)) {
-            nodeQ.pop();
-            continue;
-        }
+        int node = nodeQ.front();
+        nodeQ.pop_front();
+        int costSoFar = dist[node];
 
-        reachable.push_back(node.id);
-        sort(std::begin(reachable), std::end(reachable));
+        for (auto nbr : neighbors_(node)) {
+            auto cost = costSoFar + stepCost_(node, nbr);
+            if (cost > maxDist) continue;
 
-        for (auto nbr : neighbors_(node.id)) {
-            auto cost = node.costSoFar + stepCost_(node.id, nbr);
-            if (cost <= maxDist) {
-                nodeQ.emplace(BfsNode{nbr, cost});
+            auto iter = dist.find(nbr);
+            if (iter == dist.end()) {
+                dist.emplace(nbr, cost);
+                nodeQ.push_back(nbr);
+            }
+            else if (cost < iter->second) {
+                iter->second = cost;
+                nodeQ.push_back(nbr);
             }
         }
+    }
 
-        nodeQ.pop();
+    std::vector<int> reachable;
+    for (const auto &d : dist) {
+        reachable.push_back(d.first);
     }
+    sort(std::begin(reachable), std::end(reachable));
 
     // AI players use this function when computing possible moves.  All else
     // equal, it looks better if the AI prefers to stand still and attack an
@@ -193,3 +375,56 @@ std::vector<int> Pathfinder::getReachableNodes(int start, int maxDist) const
 
     return reachable;
 }
+
+ReachableSet Pathfinder::getReachable(int start, int maxDist) const
+{
+    assert(numNodes_ > 0);
+    FunctionPathfinder pf{numNodes_, NeighborList{&neighbors_},
+                          StepCostRef{&stepCost_}, EstimateRef{&estimate_}};
+    return pf.getReachable(start, maxDist);
+}
+
+const ReachableSet::Entry * ReachableSet::find(int node) const
+{
+    if (entries.empty()) return nullptr;
+
+    // Past the start node, entries are two ascending runs: the nodes greater
+    // than it, then the ones less than it.
+    int start = entries.front().node;
+    if (node == start) return &entries.front();
+
+    auto first = std::begin(entries) + 1;
+    auto last = std::end(entries);
+    auto wrap = std::partition_point(first, last, [=] (const Entry &e) {
+        return e.node > start;
+    });
+    if (node > start) {
+        last = wrap;
+    }
+    else {
+        first = wrap;
+    }
+
+    auto iter = std::lower_bound(first, last, node,
+        [] (const Entry &e, int n) {return e.node < n;});
+    if (iter == last || iter->node != node) return nullptr;
+    return &*iter;
+}
+
+bool ReachableSet::contains(int node) const
+{
+    auto entry = find(node);
+    return entry && entry->dist >= 0;
+}
+
+std::vector<int> ReachableSet::getPathTo(int node) const
+{
+    if (!contains(node)) return {};
+
+    std::vector<int> path;
+    for (int n = node; n != -1; n = find(n)->prev) {
+        path.push_back(n);
+    }
+    reverse(std::begin(path), std::end(path));
+    return path;
+}
@@ -13,11 +13,162 @@
 #ifndef PATHFINDER_H
 #define PATHFINDER_H
 
+#include <algorithm>
+#include <cassert>
 #include <functional>
 #include <vector>
 
+// Every node within some distance of a starting node, and the tree of
+// shortest paths leading back to it.  Only the nodes in range are stored, so
+// a search over a big graph doesn't have to return a table of all of them.
+struct ReachableSet
+{
+    struct Entry
+    {
+        int node;
+        int dist;  // -1 if there's no path, see GameState::getReachable()
+        int prev;  // next node toward the start, -1 for the start
+    };
+
+    // Start node first, then the rest in ascending order (wrapping around
+    // after the largest).
+    std::vector<Entry> entries;
+
+    // Return null if the node isn't in range.
+    const Entry * find(int node) const;
+    bool contains(int node) const;
+
+    // Return the shortest path from the start node to the given node, or an
+    // empty list if it's out of range.
+    std::vector<int> getPathTo(int node) const;
+};
+
+// Fixed-size list of nodes, for neighbor functions to fill in without
+// allocating.  Enough for a hex grid; see BasicPathfinder for graphs with more
+// neighbors per node.
+class NodeList
+{
+public:
+    static const int MAX_SIZE = 12;
+
+    NodeList() : nodes_(), size_{0} {}
+
+    void push_back(int node)
+    {
+        assert(size_ < MAX_SIZE);
+        nodes_[size_++] = node;
+    }
+
+    int size() const {return size_;}
+    const int * begin() const {return nodes_;}
+    const int * end() const {return nodes_ + size_;}
+
+private:
+    int nodes_[MAX_SIZE];
+    int size_;
+};
+
+// Default functions for BasicPathfinder: every step costs 1, and there's no
+// estimate of the distance left to the goal.
+struct UnitStepCost
+{
+    int operator()(int, int) const {return 1;}
+};
+
+struct NoEstimate
+{
+    int operator()(int) const {return 0;}
+};
+
+// Node data for BasicPathfinder searches, both A* and reachability.  Each
+// thread keeps one and reuses it from one search to the next.  A node's data is only valid if its
+// generation matches the current search, so starting a new search doesn't
+// have to clear the arrays.  The open list tracks every node's position in
+// it, so a node whose cost improves moves up the heap in place instead of
+// the whole heap being rebuilt.
+class AstarNodes
+{
+public:
+    struct Node
+    {
+        int prev;
+        int costSoFar;
+        int estTotalCost;
+        unsigned generation;
+        int heapPos;  // index into the open list, -1 once visited
+    };
+
+    AstarNodes();
+
+    // Return this thread's instance, ready for a new search.  Any previous
+    // search on this thread is finished with.
+    static AstarNodes & startSearch(int numNodes);
+
+    // Return null if the node hasn't been seen this search.
+    Node * find(int n);
+    Node & get(int n);
+
+    void add(int n, int prev, int costSoFar, int estTotalCost);
+    void decreaseKey(int n);  // call after lowering the estimated cost
+    bool empty() const;
+    int pop();
+
+private:
+    void start(int numNodes);
+    int cost(int pos) const;
+    void place(int n, int pos);
+    void siftUp(int pos);
+    void siftDown(int pos);
+
+    std::vector<Node> nodes_;
+    std::vector<int> open_;
+    unsigned generation_;
+};
+
+// A* and reachability searches over the nodes [0, numNodes), like the array
+// indexes of a HexGrid.  The graph is described by function objects, which
+// the compiler can inline into the search loops:
+//     void neighbors(int n, NodeList &nbrs) -> add the neighbors of n
+//     int stepCost(int a, int b) -> cost of moving from a to b, not negative
+//     int estimate(int n) -> lower bound on the cost from n to the goal
+//     bool goal(int n) -> return true if n is the goal
+// See Pathfinder for what each one means.  Neighbors go into a List, which
+// needs push_back(), begin(), and end().  NodeList holds up to
+// NodeList::MAX_SIZE of them; use another type if nodes can have more.
+template <class Neighbors, class StepCost = UnitStepCost,
+          class Estimate = NoEstimate, class List = NodeList>
+class BasicPathfinder
+{
+public:
+    BasicPathfinder(int numNodes, Neighbors neighbors,
+                    StepCost stepCost = StepCost(),
+                    Estimate estimate = Estimate());
+
+    // Return the shortest path from the starting node to the goal, or an
+    // empty list if the goal cannot be found.
+    template <class Goal>
+    std::vector<int> getPathFrom(int start, Goal goal) const;
+    std::vector<int> getPathFrom(int start, int goalNode) const;
+
+    // Same as Pathfinder::getReachable().
+    ReachableSet getReachable(int start, int maxDist) const;
+
+private:
+    int numNodes_;
+    Neighbors neighbors_;
+    StepCost stepCost_;
+    Estimate estimate_;
+};
+
+template <class Neighbors>
+BasicPathfinder<Neighbors> makePathfinder(int numNodes, Neighbors neighbors)
+{
+    return BasicPathfinder<Neighbors>(numNodes, std::move(neighbors));
+}
+
 // Generic implementation of the A* algorithm.  Suitable for any map or graph
-// whose nodes can be represented by integers.
+// whose nodes can be represented by integers.  Easier to set up than
+// BasicPathfinder, at the cost of an indirect call for every function.
 class Pathfinder
 {
 public:
@@ -46,19 +197,165 @@ public:
     // int (int a) -> estimate shortest path from node a to goal.
     void setEstimate(std::function<int (int)> func);
 
+    // (OPTIONAL) Declare that every node is in the range [0, numNodes), like
+    // the array indexes of a HexGrid.  Searches then run on BasicPathfinder,
+    // which keeps node data in flat arrays instead of a hash table.
+    void setNumNodes(int numNodes);
+
     // Return the shortest path to the goal from the starting node.  Return an
     // empty list if the goal cannot be found.
     std::vector<int> getPathFrom(int start) const;
 
     // Return the set of all reachable nodes from the starting node, up to a
-    // maximum distance.
+    // maximum distance.  The starting node is always first.
     std::vector<int> getReachableNodes(int start, int maxDist) const;
 
+    // Same, plus the paths to get there.  Requires setNumNodes().
+    ReachableSet getReachable(int start, int maxDist) const;
+
 private:
     std::function<std::vector<int> (int)> neighbors_;
     std::function<bool (int)> goal_;
     std::function<int (int, int)> stepCost_;
     std::function<int (int)> estimate_;
+    int numNodes_;  // 0 if not known
 };
 
+
+
+template <class Neighbors, class StepCost, class Estimate, class List>
+BasicPathfinder<Neighbors, StepCost, Estimate, List>::BasicPathfinder(
+    int numNodes, Neighbors neighbors, StepCost stepCost, Estimate estimate)
+    : numNodes_{numNodes},
+    neighbors_(std::move(neighbors)),
+    stepCost_(std::move(stepCost)),
+    estimate_(std::move(estimate))
+{
+    assert(numNodes_ > 0);
+}
+
+template <class Neighbors, class StepCost, class Estimate, class List>
+template <class Goal>
+std::vector<int> BasicPathfinder<Neighbors, StepCost, Estimate, List>::getPathFrom(
+    int start, Goal goal) const
+{
+    assert(start >= 0 && start < numNodes_);
+    if (goal(start)) return {start};
+
+    auto &search = AstarNodes::startSearch(numNodes_);
+    search.add(start, -1, 0, 0);
+
+    // A* algorithm.  Decays to Dijkstra's if estimate function is always 0.
+    // Visited nodes are the ones that have left the open list.
+    int goalLoc = -1;
+    while (!search.empty()) {
+        auto loc = search.pop();
+        if (goal(loc)) {
+            goalLoc = loc;
+            break;
+        }
+
+        int costSoFar = search.get(loc).costSoFar;
+        List nbrs;
+        neighbors_(loc, nbrs);
+        for (auto n : nbrs) {
+            assert(n >= 0 && n < numNodes_);
+            auto step = stepCost_(loc, n);
+
+            auto nNode = search.find(n);
+            if (nNode) {
+                if (nNode->heapPos < 0) {
+                    continue;
+                }
+
+                // Are we on a shorter path to the neighbor node than what
+                // we've already seen?  If so, update the neighbor's node data.
+                if (costSoFar + step < nNode->costSoFar) {
+                    nNode->prev = loc;
+                    nNode->costSoFar = costSoFar + step;
+                    nNode->estTotalCost = nNode->costSoFar + estimate_(n);
+                    search.decreaseKey(n);
+                }
+            }
+            else {
+                search.add(n, loc, costSoFar + step,
+                           costSoFar + step + estimate_(n));
+            }
+        }
+    }
+
+    if (goalLoc == -1) {
+        return {};
+    }
+
+    // Build the path from the chain of nodes leading to the goal.
+    std::vector<int> path;
+    for (int n = goalLoc; n != -1; n = search.get(n).prev) {
+        path.push_back(n);
+    }
+    reverse(std::begin(path), std::end(path));
+    assert(path.front() == start);
+    return path;
+}
+
+template <class Neighbors, class StepCost, class Estimate, class List>
+std::vector<int> BasicPathfinder<Neighbors, StepCost, Estimate, List>::getPathFrom(
+    int start, int goalNode) const
+{
+    return getPathFrom(start, [=] (int n) {return n == goalNode;});
+}
+
+template <class Neighbors, class StepCost, class Estimate, class List>
+ReachableSet BasicPathfinder<Neighbors, StepCost, Estimate, List>::getReachable(
+    int start, int maxDist) const
+{
+    assert(start >= 0 && start < numNodes_);
+
+    // Dijkstra's algorithm in the same scratch space as A*, stopping at
+    // 'maxDist' instead of at a goal.  Nodes still have to leave the open
+    // list before they're final, a cheaper path to them might turn up.
+    auto &search = AstarNodes::startSearch(numNodes_);
+    search.add(start, -1, 0, 0);
+    int numFound = 1;
+
+    while (!search.empty()) {
+        auto node = search.pop();
+        int costSoFar = search.get(node).costSoFar;
+
+        List nbrs;
+        neighbors_(node, nbrs);
+        for (auto nbr : nbrs) {
+            assert(nbr >= 0 && nbr < numNodes_);
+            auto cost = costSoFar + stepCost_(node, nbr);
+            if (cost > maxDist) continue;
+
+            auto nNode = search.find(nbr);
+            if (!nNode) {
+                search.add(nbr, node, cost, cost);
+                ++numFound;
+            }
+            else if (nNode->heapPos >= 0 && cost < nNode->costSoFar) {
+                nNode->prev = node;
+                nNode->costSoFar = cost;
+                nNode->estTotalCost = cost;
+                search.decreaseKey(nbr);
+            }
+        }
+    }
+
+    // See Pathfinder::getReachableNodes() for why the starting node goes
+    // first.
+    ReachableSet result;
+    result.entries.reserve(numFound);
+    for (int i = 0; i < numNodes_; ++i) {
+        int n = (start + i) % numNodes_;
+        auto found = search.find(n);
+        if (found) {
+            result.entries.push_back({n, found->costSoFar, found->prev});
+        }
+    }
+
+    return result;
+}
+
 #endif
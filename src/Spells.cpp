@@ -13,6 +13,7 @@
 #include "Spells.h"
 
 #include "algo.h"
+#include <iostream>
 #include <memory>
 #include <unordered_map>
 
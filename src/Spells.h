@@ -45,7 +45,7 @@ struct Spell
     Spell(SpellType t, const rapidjson::Value &json);
 };
 
-// Call this after SDL and effects initialized but before loading game data.
+// Call this after effects are initialized but before loading game data.
 bool initSpellCache(const char *filename);
 
 const Spell * getSpell(SpellType type);
@@ -39,21 +39,16 @@ namespace {
     }
 }
 
-bool operator<(Trait lhs, Trait rhs)
-{
-    return static_cast<int>(lhs) < static_cast<int>(rhs);
-}
-
-std::vector<Trait> parseTraits(const rapidjson::Value &json)
+TraitMask parseTraits(const rapidjson::Value &json)
 {
     if (allTraits.empty()) initTraits();
 
-    std::vector<Trait> traits;
+    TraitMask traits = 0;
 
     for (const auto &str : jsonListStr(json)) {
         auto i = allTraits.find(to_upper(str));
         if (i != allTraits.end()) {
-            traits.push_back(i->second);
+            traits |= traitBit(i->second);
         }
         else {
             std::cerr << "Unrecognized trait: " << str << '\n';
@@ -63,13 +58,15 @@ std::vector<Trait> parseTraits(const rapidjson::Value &json)
     return traits;
 }
 
-std::string strFromTraits(const std::vector<Trait> &traits)
+std::string strFromTraits(TraitMask traits)
 {
-    if (traits.empty()) return {};
+    if (traits == 0) return {};
+    if (traitStr.empty()) initTraits();
 
     std::string ret;
-    for (auto t : traits) {
-        ret += traitStr[static_cast<int>(t)];
+    for (int t = 0; t < NUM_TRAITS; ++t) {
+        if ((traits & traitBit(static_cast<Trait>(t))) == 0) continue;
+        ret += traitStr[t];
         ret += ", ";
     }
     ret.erase(ret.size() - 2);
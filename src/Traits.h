@@ -14,8 +14,8 @@
 #define TRAITS_H
 
 #include "json_utils.h"
+#include <cstdint>
 #include <string>
-#include <vector>
 
 #define UNIT_TRAITS \
     X(BINDING) \
@@ -34,11 +34,23 @@
 #define X(str) str,
 enum class Trait {UNIT_TRAITS};
 #undef X
-bool operator<(Trait lhs, Trait rhs);
 
-std::vector<Trait> parseTraits(const rapidjson::Value &json);
+#define X(str) + 1
+constexpr int NUM_TRAITS = 0 UNIT_TRAITS;
+#undef X
+
+// Set of traits, one bit per trait, so testing for one is a single AND.
+using TraitMask = uint16_t;
+static_assert(NUM_TRAITS <= 16, "too many traits for TraitMask");
+
+constexpr TraitMask traitBit(Trait t)
+{
+    return static_cast<TraitMask>(1u << static_cast<int>(t));
+}
+
+TraitMask parseTraits(const rapidjson::Value &json);
 
-// Convert a list of traits into a string separated by commas.
-std::string strFromTraits(const std::vector<Trait> &traits);
+// Convert a set of traits into a string separated by commas.
+std::string strFromTraits(TraitMask traits);
 
 #endif
@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "TranspositionTable.h"
+
+#include <cassert>
+
+namespace
+{
+    // Layout of the data word: value in the low 32 bits, then 16 bits of
+    // best action index, 8 bits of depth, 2 bits of bound type, and a flag
+    // to tell a stored entry from an empty slot.
+    const uint64_t USED_FLAG = 1ULL << 58;
+}
+
+TranspositionTable::TranspositionTable(int sizeLog2)
+    : slots_(1u << sizeLog2),
+    mask_{(1ULL << sizeLog2) - 1}
+{
+    assert(sizeLog2 > 0 && sizeLog2 < 32);
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t hash, Entry &entry) const
+{
+    uint64_t data = 0;
+    if (!read(hash, data)) return false;
+
+    entry = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t hash, const Entry &entry)
+{
+    // Keep a deeper result for the same position, it's more valuable than a
+    // shallow one.
+    uint64_t prev = 0;
+    if (read(hash, prev) && unpack(prev).depth > entry.depth) return;
+
+    auto &slot = slots_[hash & mask_];
+    uint64_t data = pack(entry);
+    slot.check.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear()
+{
+    for (auto &slot : slots_) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::read(uint64_t hash, uint64_t &data) const
+{
+    const auto &slot = slots_[hash & mask_];
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    data = slot.data.load(std::memory_order_relaxed);
+    return (data & USED_FLAG) && (check ^ data) == hash;
+}
+
+uint64_t TranspositionTable::pack(const Entry &entry)
+{
+    assert(entry.depth >= 0 && entry.depth < 256);
+    assert(entry.bestIndex >= -1 && entry.bestIndex < 0xffff);
+
+    uint64_t data = static_cast<uint32_t>(entry.value);
+    data |= static_cast<uint64_t>(entry.bestIndex + 1) << 32;
+    data |= static_cast<uint64_t>(entry.depth) << 48;
+    data |= static_cast<uint64_t>(entry.bound) << 56;
+    return data | USED_FLAG;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data)
+{
+    Entry entry;
+    entry.value = static_cast<int32_t>(data & 0xffffffff);
+    entry.bestIndex = static_cast<int>((data >> 32) & 0xffff) - 1;
+    entry.depth = static_cast<int>((data >> 48) & 0xff);
+    entry.bound = static_cast<Bound>((data >> 56) & 0x3);
+    return entry;
+}
@@ -0,0 +1,67 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// How a stored search value relates to the true value of a position.
+enum class Bound { EXACT, LOWER, UPPER };
+
+// Fixed-size cache of alpha-beta search results, indexed by the Zobrist hash
+// of the position (see GameState::getHash()).  Newer and deeper results
+// replace older ones in the same slot.  Any number of threads may probe and
+// store at the same time without locking.
+class TranspositionTable
+{
+public:
+    struct Entry
+    {
+        int value;
+        int depth;  // remaining search depth that produced 'value'
+        Bound bound;
+        int bestIndex;  // index into getPossibleActions(), -1 if unknown
+    };
+
+    // Table holds 2^sizeLog2 entries.
+    explicit TranspositionTable(int sizeLog2);
+
+    // Return true and fill in 'entry' if the position has been stored.
+    bool probe(uint64_t hash, Entry &entry) const;
+    void store(uint64_t hash, const Entry &entry);
+
+    void clear();
+
+private:
+    // Each entry is packed into two words so a probe touches one cache line.
+    // The first word holds key ^ data, so if two threads write the same slot
+    // at once, the mismatched halves fail the key check instead of returning
+    // another position's data.
+    struct Slot
+    {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    bool read(uint64_t hash, uint64_t &data) const;
+
+    static uint64_t pack(const Entry &entry);
+    static Entry unpack(uint64_t data);
+
+    std::vector<Slot> slots_;
+    uint64_t mask_;
+};
+
+#endif
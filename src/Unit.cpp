@@ -81,39 +81,53 @@ int Unit::avgDamage(ActionType action) const
     return damage;
 }
 
+std::pair<int, int> Unit::damageRoll(ActionType action) const
+{
+    if (!isValid()) return {0, 0};
+
+    if (action == ActionType::ATTACK || action == ActionType::RETALIATE) {
+        return {type->minDmg, type->maxDmg};
+    }
+    else if (action == ActionType::RANGED) {
+        return {type->minDmgRanged, type->maxDmgRanged};
+    }
+    return {0, 0};
+}
+
 int Unit::takeDamage(int dmg)
 {
     if (!isValid()) return 0;
 
+    auto result = damageResult(dmg);
+    num -= result.first;
+    hpLeft = result.second;
+    return result.first;
+}
+
+int Unit::simulateDamage(int dmg) const
+{
+    return damageResult(dmg).first;
+}
+
+std::pair<int, int> Unit::damageResult(int dmg) const
+{
+    if (!isValid()) return {0, hpLeft};
+
     if (dmg < hpLeft) {
-        hpLeft -= dmg;
-        return 0;
+        return {0, hpLeft - dmg};
     }
 
-    int startSize = num;
-
-    // Remove the top creature in the stack.
+    // Remove the top creature in the stack, then as many whole creatures as
+    // possible.
     dmg -= hpLeft;
-    hpLeft = type->hp;
-    --num;
-
-    // Remove as many whole creatures as possible.
     auto result = div(dmg, type->hp);
-    num -= result.quot;
-    if (num < 0) {
-        num = 0;
-        hpLeft = 0;
-        return startSize;
+    int numKilled = result.quot + 1;
+    if (numKilled >= num) {
+        return {num, 0};
     }
 
     // Damage the top remaining creature.
-    hpLeft -= result.rem;
-    return startSize - num;
-}
-
-int Unit::simulateDamage(int dmg) const
-{
-    return Unit(*this).takeDamage(dmg);
+    return {numKilled, type->hp - result.rem};
 }
 
 std::string Unit::getName(int number) const
@@ -149,7 +163,7 @@ unsigned Unit::getMaxPathSize() const
 bool Unit::hasTrait(Trait t) const
 {
     if (!isValid()) return false;
-    return contains(type->traits, t);
+    return (type->traits & traitBit(t)) != 0;
 }
 
 bool Unit::hasEffect(EffectType e) const
@@ -17,6 +17,7 @@
 #include "Effects.h"
 #include "Traits.h"
 #include <string>
+#include <utility>
 
 class UnitType;
 
@@ -46,10 +47,18 @@ struct Unit
     int randomDamage(ActionType action) const;
     int avgDamage(ActionType action) const;
 
+    // Range of the roll behind randomDamage(), before doubling for Enraged.
+    std::pair<int, int> damageRoll(ActionType action) const;
+
     // Apply damage, return number of creatures killed.
     int takeDamage(int dmg);
     int simulateDamage(int dmg) const;
 
+    // What takeDamage() would do without changing the unit: number of
+    // creatures killed and hp of the top creature afterward (0 if none are
+    // left).
+    std::pair<int, int> damageResult(int dmg) const;
+
     bool isValid() const;  // return false if default-constructed
     bool isAlive() const;
 
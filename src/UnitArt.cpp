@@ -0,0 +1,141 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "UnitArt.h"
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    void loadImages(const rapidjson::Value &json,
+                    const char *imgName,
+                    ImageSet &img,
+                    ImageSet &reverseImg)
+    {
+        auto tempImg = sdlLoadImage(json[imgName].GetString());
+        if (tempImg) {
+            img = applyTeamColors(tempImg);
+            reverseImg = applyTeamColors(sdlFlipH(tempImg));
+        }
+    }
+
+    void loadAnimation(const rapidjson::Value &json,
+                       const char *animName,
+                       ImageSet &anim,
+                       ImageSet &reverseAnim,
+                       const char *framesName,
+                       FrameList &frames)
+    {
+        frames = jsonListUnsigned(json[framesName]);
+
+        auto baseAnim = sdlLoadImage(json[animName].GetString());
+        if (baseAnim) {
+            anim = applyTeamColors(baseAnim);
+            reverseAnim = applyTeamColors(sdlFlipSheetH(baseAnim,
+                frames.size()));
+        }
+    }
+}
+
+UnitArt::UnitArt(const rapidjson::Value &json)
+    : baseImg{},
+    reverseImg{},
+    imgMove{},
+    reverseImgMove{},
+    sndMove{},
+    animAttack{},
+    reverseAnimAttack{},
+    attackFrames{},
+    animRanged{},
+    reverseAnimRanged{},
+    rangedFrames{},
+    projectile{},
+    sndAttack{},
+    sndRanged{},
+    imgDefend{},
+    reverseImgDefend{},
+    sndDefend{},
+    animDie{},
+    reverseAnimDie{},
+    dieFrames{},
+    sndDie{}
+{
+    if (json.HasMember("img")) {
+        loadImages(json, "img", baseImg, reverseImg);
+    }
+    if (json.HasMember("img-move")) {
+        loadImages(json, "img-move", imgMove, reverseImgMove);
+    }
+    if (json.HasMember("img-defend")) {
+        loadImages(json, "img-defend", imgDefend, reverseImgDefend);
+    }
+    if (json.HasMember("anim-attack") && json.HasMember("attack-frames")) {
+        loadAnimation(json, "anim-attack", animAttack, reverseAnimAttack,
+                      "attack-frames", attackFrames);
+    }
+    if (json.HasMember("anim-ranged") && json.HasMember("ranged-frames")) {
+        loadAnimation(json, "anim-ranged", animRanged, reverseAnimRanged,
+                      "ranged-frames", rangedFrames);
+    }
+    if (json.HasMember("projectile")) {
+        projectile = sdlLoadImage(json["projectile"].GetString());
+    }
+    if (json.HasMember("sound-move")) {
+        sndMove = sdlLoadSound(json["sound-move"].GetString());
+    }
+    if (json.HasMember("sound-attack")) {
+        sndAttack = sdlLoadSound(json["sound-attack"].GetString());
+    }
+    if (json.HasMember("sound-ranged")) {
+        sndRanged = sdlLoadSound(json["sound-ranged"].GetString());
+    }
+    if (json.HasMember("sound-defend")) {
+        sndDefend = sdlLoadSound(json["sound-defend"].GetString());
+    }
+    if (json.HasMember("sound-die")) {
+        sndDie = sdlLoadSound(json["sound-die"].GetString());
+    }
+    if (json.HasMember("anim-die") && json.HasMember("die-frames")) {
+        loadAnimation(json, "anim-die", animDie, reverseAnimDie, "die-frames",
+                      dieFrames);
+    }
+
+    if (json.HasMember("damage-ranged") && !projectile) {
+        const char *name = json.HasMember("name") ? json["name"].GetString() :
+                                                    "";
+        std::cerr << "WARNING: projectile not specified for " << name << '\n';
+        projectile = sdlLoadImage("missile.png");
+    }
+}
+
+SdlSound UnitArt::getDieSound() const
+{
+    if (sndDie) return sndDie;
+    return sndDefend;
+}
+
+bool loadUnitArt(UnitTypeMap &unitRef)
+{
+    rapidjson::Document unitsDoc;
+    if (!jsonParse("units.json", unitsDoc)) {
+        return false;
+    }
+
+    for (auto i = unitsDoc.MemberBegin(); i != unitsDoc.MemberEnd(); ++i) {
+        auto iter = unitRef.find(i->name.GetString());
+        if (iter == unitRef.end() || !i->value.IsObject()) continue;
+
+        iter->second.art = std::make_shared<UnitArt>(i->value);
+    }
+
+    return true;
+}
@@ -0,0 +1,57 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef UNIT_ART_H
+#define UNIT_ART_H
+
+#include "UnitType.h"
+#include "json_utils.h"
+#include "sdl_helper.h"
+#include "team_color.h"
+
+// Images, animations, and sounds for one unit type.  Only the front end
+// (animations and unit views) uses these.
+struct UnitArt
+{
+    ImageSet baseImg;
+    ImageSet reverseImg;
+    ImageSet imgMove;
+    ImageSet reverseImgMove;
+    SdlSound sndMove;
+    ImageSet animAttack;
+    ImageSet reverseAnimAttack;
+    FrameList attackFrames;
+    ImageSet animRanged;
+    ImageSet reverseAnimRanged;
+    FrameList rangedFrames;
+    SdlSurface projectile;
+    SdlSound sndAttack;
+    SdlSound sndRanged;
+    ImageSet imgDefend;
+    ImageSet reverseImgDefend;
+    SdlSound sndDefend;
+    ImageSet animDie;
+    ImageSet reverseAnimDie;
+    FrameList dieFrames;
+    SdlSound sndDie;
+
+    UnitArt(const rapidjson::Value &json);
+
+    // Use the defend sound if no die sound is available.
+    SdlSound getDieSound() const;
+};
+
+// Load the art for every unit type in 'unitRef' from the units file.  Call
+// this after SDL initialized and loadGameData().
+bool loadUnitArt(UnitTypeMap &unitRef);
+
+#endif
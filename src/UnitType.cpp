@@ -11,46 +11,11 @@
     See the COPYING.txt file for more details.
 */
 #include "UnitType.h"
-#include "algo.h"
-#include <algorithm>
-#include <iostream>
-
-namespace
-{
-    void loadImages(const rapidjson::Value &json,
-                    const char *imgName,
-                    ImageSet &img,
-                    ImageSet &reverseImg)
-    {
-        auto tempImg = sdlLoadImage(json[imgName].GetString());
-        if (tempImg) {
-            img = applyTeamColors(tempImg);
-            reverseImg = applyTeamColors(sdlFlipH(tempImg));
-        }
-    }
-
-    void loadAnimation(const rapidjson::Value &json,
-                       const char *animName,
-                       ImageSet &anim,
-                       ImageSet &reverseAnim,
-                       const char *framesName,
-                       FrameList &frames)
-    {
-        frames = jsonListUnsigned(json[framesName]);
 
-        auto baseAnim = sdlLoadImage(json[animName].GetString());
-        if (baseAnim) {
-            anim = applyTeamColors(baseAnim);
-            reverseAnim = applyTeamColors(sdlFlipSheetH(baseAnim,
-                frames.size()));
-        }
-    }
-}
+#include <iostream>
 
 UnitType::UnitType(const rapidjson::Value &json)
-    : name{},
-    plural{},
-    moves{1},
+    : moves{1},
     initiative{0},
     hp{1},
     minDmg{0},
@@ -58,32 +23,12 @@ UnitType::UnitType(const rapidjson::Value &json)
     minDmgRanged{0},
     maxDmgRanged{0},
     growth{1},
-    traits{},
+    traits{0},
     spell{nullptr},
-    baseImg{},
-    reverseImg{},
-    imgMove{},
-    reverseImgMove{},
-    sndMove{},
-    animAttack{},
-    reverseAnimAttack{},
-    attackFrames{},
-    animRanged{},
-    reverseAnimRanged{},
-    rangedFrames{},
-    projectile{},
-    sndAttack{},
-    sndRanged{},
-    imgDefend{},
-    reverseImgDefend{},
-    sndDefend{},
-    animDie{},
-    reverseAnimDie{},
-    dieFrames{},
-    sndDie{}
+    name{},
+    plural{},
+    art{}
 {
-    bool hasRangedAttack = false;
-
     if (json.HasMember("name")) {
         name = json["name"].GetString();
     }
@@ -96,30 +41,13 @@ UnitType::UnitType(const rapidjson::Value &json)
     if (json.HasMember("hp")) {
         hp = json["hp"].GetInt();
     }
-    if (json.HasMember("img")) {
-        loadImages(json, "img", baseImg, reverseImg);
-    }
-    if (json.HasMember("img-move")) {
-        loadImages(json, "img-move", imgMove, reverseImgMove);
-    }
-    if (json.HasMember("img-defend")) {
-        loadImages(json, "img-defend", imgDefend, reverseImgDefend);
-    }
-    if (json.HasMember("anim-attack") && json.HasMember("attack-frames")) {
-        loadAnimation(json, "anim-attack", animAttack, reverseAnimAttack,
-                      "attack-frames", attackFrames);
-    }
-    if (json.HasMember("anim-ranged") && json.HasMember("ranged-frames")) {
-        loadAnimation(json, "anim-ranged", animRanged, reverseAnimRanged,
-                      "ranged-frames", rangedFrames);
-    }
     if (json.HasMember("damage")) {
         const auto &damageList = json["damage"];
         minDmg = damageList[0u].GetInt();
         maxDmg = damageList[1u].GetInt();
     }
     if (json.HasMember("damage-ranged")) {
-        hasRangedAttack = true;
+        traits |= traitBit(Trait::RANGED);
 
         const auto &damageList = json["damage-ranged"];
         minDmgRanged = damageList[0u].GetInt();
@@ -128,60 +56,20 @@ UnitType::UnitType(const rapidjson::Value &json)
     if (json.HasMember("growth")) {
         growth = json["growth"].GetInt();
     }
-    if (json.HasMember("projectile")) {
-        projectile = sdlLoadImage(json["projectile"].GetString());
-    }
-    if (json.HasMember("sound-move")) {
-        sndMove = sdlLoadSound(json["sound-move"].GetString());
-    }
-    if (json.HasMember("sound-attack")) {
-        sndAttack = sdlLoadSound(json["sound-attack"].GetString());
-    }
-    if (json.HasMember("sound-ranged")) {
-        sndRanged = sdlLoadSound(json["sound-ranged"].GetString());
-    }
-    if (json.HasMember("sound-defend")) {
-        sndDefend = sdlLoadSound(json["sound-defend"].GetString());
-    }
-    if (json.HasMember("sound-die")) {
-        sndDie = sdlLoadSound(json["sound-die"].GetString());
-    }
-    if (json.HasMember("anim-die") && json.HasMember("die-frames")) {
-        loadAnimation(json, "anim-die", animDie, reverseAnimDie, "die-frames",
-                      dieFrames);
-    }
     if (json.HasMember("traits")) {
-        auto tlist = parseTraits(json["traits"]);
-        traits.insert(std::end(traits), std::begin(tlist), std::end(tlist));
+        traits |= parseTraits(json["traits"]);
     }
     if (json.HasMember("spell")) {
         spell = getSpell(json["spell"].GetString());
         if (spell) {
-            traits.push_back(Trait::SPELLCASTER);
+            traits |= traitBit(Trait::SPELLCASTER);
         }
         else {
             std::cerr << "WARNING: unrecognized spell for " << name << '\n';
         }
     }
 
-    if (hasRangedAttack) {
-        traits.push_back(Trait::RANGED);
-        if (!projectile) {
-            std::cerr << "WARNING: projectile not specified for " <<
-                name << '\n';
-            projectile = sdlLoadImage("missile.png");
-        }
-    }
-
-    if (contains(traits, Trait::MOUNTED)) {
+    if (traits & traitBit(Trait::MOUNTED)) {
         moves = 2;
     }
-
-    sort(std::begin(traits), std::end(traits));
-}
-
-SdlSound UnitType::getDieSound() const
-{
-    if (sndDie) return sndDie;
-    return sndDefend;
 }
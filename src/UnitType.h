@@ -16,19 +16,18 @@
 #include "Spells.h"
 #include "Traits.h"
 #include "json_utils.h"
-#include "sdl_helper.h"
-#include "team_color.h"
 
+#include <memory>
 #include <string>
 #include <unordered_map>
-#include <vector>
 
-// Definition of each unit type.  Contains all combat stats, descriptive info,
-// images, and animations.
+struct UnitArt;
+
+// Definition of each unit type.  The combat stats the AI reads at every search
+// node come first, so they share a cache line.  Images and sounds live in a
+// separate UnitArt that only the front end touches.
 struct UnitType
 {
-    std::string name;
-    std::string plural;
     int moves;
     int initiative;
     int hp;
@@ -37,34 +36,13 @@ struct UnitType
     int minDmgRanged;
     int maxDmgRanged;
     int growth;
-    std::vector<Trait> traits;
+    TraitMask traits;
     const Spell *spell;
-    ImageSet baseImg;
-    ImageSet reverseImg;
-    ImageSet imgMove;
-    ImageSet reverseImgMove;
-    SdlSound sndMove;
-    ImageSet animAttack;
-    ImageSet reverseAnimAttack;
-    FrameList attackFrames;
-    ImageSet animRanged;
-    ImageSet reverseAnimRanged;
-    FrameList rangedFrames;
-    SdlSurface projectile;
-    SdlSound sndAttack;
-    SdlSound sndRanged;
-    ImageSet imgDefend;
-    ImageSet reverseImgDefend;
-    SdlSound sndDefend;
-    ImageSet animDie;
-    ImageSet reverseAnimDie;
-    FrameList dieFrames;
-    SdlSound sndDie;
+    std::string name;
+    std::string plural;
+    std::shared_ptr<const UnitArt> art;  // see loadUnitArt()
 
     UnitType(const rapidjson::Value &json);
-
-    // Use the defend sound if no die sound is available.
-    SdlSound getDieSound() const;
 };
 
 using UnitTypeMap = std::unordered_map<std::string, UnitType>;
@@ -14,8 +14,8 @@
 
 #include "Effects.h"
 #include "GameState.h"
+#include "UnitArt.h"
 #include "UnitType.h"
-#include "algo.h"
 #include <algorithm>
 #include <cassert>
 #include <sstream>
@@ -82,7 +82,7 @@ namespace
 
     SdlSurface renderSpellTraits(const Unit &unit)
     {
-        assert(contains(unit.type->traits, Trait::SPELLCASTER));
+        assert(unit.type->traits & traitBit(Trait::SPELLCASTER));
 
         // TODO: building up text like this is awkward.
         auto str = strFromTraits(unit.type->traits);
@@ -105,9 +105,9 @@ namespace
 
     SdlSurface renderTraits(const Unit &unit)
     {
-        const auto &traits = unit.type->traits;
-        if (traits.empty()) return {};
-        if (contains(traits, Trait::SPELLCASTER)) {
+        auto traits = unit.type->traits;
+        if (traits == 0) return {};
+        if (traits & traitBit(Trait::SPELLCASTER)) {
             return renderSpellTraits(unit);
         }
 
@@ -128,7 +128,7 @@ SdlSurface renderUnitView(const Unit &unit)
     assert(unit.isAlive());
 
     // Render all the pieces to determine overall window size.
-    const auto &img = unit.type->baseImg[unit.team];
+    const auto &img = unit.type->art->baseImg[unit.team];
     auto nameSurf = renderName(unit);
     auto damageSurf = renderDamage(unit);
     auto hpSurf = renderHP(unit);
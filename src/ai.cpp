@@ -14,13 +14,24 @@
 #include "ai.h"
 
 #include "Action.h"
+#include "ActionGenerator.h"
 #include "GameState.h"
+#include "Mcts.h"
+#include "TranspositionTable.h"
 #include "algo.h"
+#include "boost/thread/thread.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <deque>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -44,6 +55,38 @@
  *  alphabeta(origin, depth, -inf, +inf, TRUE)
  */
 
+SearchStats::SearchStats()
+    : depth{0},
+    nodes{0},
+    cutoffs{0},
+    firstCutoffs{0},
+    killerCutoffs{0}
+{
+}
+
+SearchStats & SearchStats::operator+=(const SearchStats &rhs)
+{
+    depth = std::max(depth, rhs.depth);
+    nodes += rhs.nodes;
+    cutoffs += rhs.cutoffs;
+    firstCutoffs += rhs.firstCutoffs;
+    killerCutoffs += rhs.killerCutoffs;
+    return *this;
+}
+
+std::ostream & operator<<(std::ostream &ostr, const SearchStats &stats)
+{
+    auto percent = [&] (unsigned long n) {
+        return stats.cutoffs > 0 ? 100 * n / stats.cutoffs : 0;
+    };
+
+    ostr << "depth " << stats.depth << ", " << stats.nodes << " nodes, " <<
+        stats.cutoffs << " cutoffs (" << percent(stats.firstCutoffs) <<
+        "% on first action, " << percent(stats.killerCutoffs) <<
+        "% by killers)";
+    return ostr;
+}
+
 // AI functions return the difference in final score (or score when the search
 // stops) of executing the best moves for both sides.  Positive values good for
 // team 0, negative values good for team 1.
@@ -54,9 +97,165 @@ int noLookAhead(const GameState &gs)
     return score[0] - score[1];
 }
 
+namespace
+{
+    // 2^18 entries, 4 MB.
+    const int TT_SIZE_LOG2 = 18;
+
+    // Iterative deepening stops here even if there's time left.
+    const int MAX_SEARCH_DEPTH = 30;
+
+    using SearchClock = std::chrono::steady_clock;
+
+    // Enough of an action to recognize it again in a sibling position.
+    struct ActionKey
+    {
+        ActionType type;
+        int attacker;
+        int defender;
+        int aMove;  // where the attacker ends up, -1 if it doesn't move
+        int aTgt;
+
+        ActionKey()
+            : type{ActionType::NONE},
+            attacker{-1},
+            defender{-1},
+            aMove{-1},
+            aTgt{-1}
+        {
+        }
+
+        explicit ActionKey(const Action &action)
+            : type{action.type},
+            attacker{action.attacker},
+            defender{action.defender},
+            aMove{action.path.empty() ? -1 : action.path.back()},
+            aTgt{action.aTgt}
+        {
+        }
+
+        bool operator==(const ActionKey &rhs) const
+        {
+            return type == rhs.type && attacker == rhs.attacker &&
+                defender == rhs.defender && aMove == rhs.aMove &&
+                aTgt == rhs.aTgt;
+        }
+    };
+
+    const int NUM_ACTION_TYPES = static_cast<int>(ActionType::EFFECT) + 1;
+
+    // History table index of an action, by target hex and action type.  The
+    // table has one row per unit type.
+    int historyIndex(const Action &action)
+    {
+        int aHex = (action.aTgt >= 0) ? action.aTgt :
+                   (!action.path.empty()) ? action.path.back() : -1;
+        return (aHex + 1) * NUM_ACTION_TYPES + static_cast<int>(action.type);
+    }
+
+    // Scratch space for one level of the search tree, reused from node to
+    // node so generating actions doesn't allocate once it has warmed up.
+    // Only the first 'size' actions are valid.
+    struct PlyBuffers
+    {
+        std::vector<Action> actions;
+        std::vector<int> rank;
+        std::vector<int> order;
+        int size;
+
+        PlyBuffers() : actions{}, rank{}, order{}, size{0} {}
+
+        // Generate the next action into the buffer, return false if there
+        // aren't any more.
+        bool generate(ActionGenerator &gen)
+        {
+            if (size == static_cast<int>(actions.size())) {
+                actions.emplace_back();
+            }
+            if (!gen.next(actions[size])) return false;
+            ++size;
+            return true;
+        }
+    };
+
+    // State shared by every node of one AI search.  Each search thread has
+    // its own context, but they may all share the same table.
+    struct SearchContext
+    {
+        TranspositionTable &tt;
+        int helperNum;  // 0 for the main thread, see alphaBeta()
+        bool hasDeadline;
+        SearchClock::time_point deadline;
+        const std::atomic<bool> *stop;  // set by another thread to abort
+        bool aborted;
+        unsigned nodes;
+        int ply;  // distance from the root action
+        bool chanceNodes;  // search each damage outcome, see searchAction()
+        int scoreBound;  // no search value is outside +/- this
+
+        // Move ordering: the last two actions that caused a cutoff at each
+        // ply, and how often each kind of action has been best.
+        std::vector<std::array<ActionKey, 2>> killers;
+        std::unordered_map<const UnitType *, std::vector<int>> history;
+        SearchStats stats;
+
+        // Growing a deque doesn't move the buffers of the plies above.
+        std::deque<PlyBuffers> plyBuffers;
+
+        explicit SearchContext(TranspositionTable &table, int helper = 0)
+            : tt(table),
+            helperNum{helper},
+            hasDeadline{false},
+            deadline{},
+            stop{nullptr},
+            aborted{false},
+            nodes{0},
+            ply{0},
+            chanceNodes{false},
+            scoreBound{std::numeric_limits<int>::max()},
+            killers(MAX_SEARCH_DEPTH + 2),
+            history{},
+            stats{},
+            plyBuffers(MAX_SEARCH_DEPTH + 2)
+        {
+        }
+
+        PlyBuffers & getPlyBuffers()
+        {
+            if (ply >= static_cast<int>(plyBuffers.size())) {
+                plyBuffers.resize(ply + 1);
+            }
+            return plyBuffers[ply];
+        }
+
+        // Checking the clock is slow compared to searching a node, so only
+        // look at it every so often.
+        bool outOfTime()
+        {
+            if (aborted) return true;
+            if ((++nodes & 0x3ff) == 0) {
+                if ((stop && *stop) ||
+                    (hasDeadline && SearchClock::now() >= deadline))
+                {
+                    aborted = true;
+                }
+            }
+            return aborted;
+        }
+    };
+}
+
+int searchAction(GameState &gs, const Action &action, int depth, int alpha,
+                 int beta, SearchContext &ctx);
+
 // source: http://en.wikipedia.org/wiki/Alpha-beta_pruning
-int alphaBeta(const GameState &gs, int depth, int alpha, int beta)
+// If the search runs out of time, the return value is meaningless and
+// ctx.aborted is set.
+int alphaBeta(GameState &gs, int depth, int alpha, int beta,
+              SearchContext &ctx)
 {
+    if (ctx.outOfTime()) return 0;
+
     // If we've run out of search time or the game has ended, stop.
     auto score = gs.getScore();
     if (score[0] == 0 || score[1] == 0) {
@@ -66,47 +265,249 @@ int alphaBeta(const GameState &gs, int depth, int alpha, int beta)
         return score[0] - score[1];
     }
 
-    for (auto &action : gs.getPossibleActions()) {
-        GameState gsCopy{gs};
-        gsCopy.runActionSeq(action);
-        gsCopy.nextTurn();
+    // Different move orders often reach the same position.  Reuse what we
+    // learned the last time if it was searched at least as deeply.
+    auto hash = gs.getHash();
+    TranspositionTable::Entry prev;
+    int ttIndex = -1;
+    if (ctx.tt.probe(hash, prev)) {
+        if (prev.depth >= depth) {
+            if (prev.bound == Bound::EXACT) return prev.value;
+            if (prev.bound == Bound::LOWER) alpha = std::max(alpha, prev.value);
+            if (prev.bound == Bound::UPPER) beta = std::min(beta, prev.value);
+            if (beta <= alpha) return prev.value;
+        }
+        ttIndex = prev.bestIndex;
+    }
+
+    ++ctx.stats.nodes;
+    auto &buf = ctx.getPlyBuffers();
+    auto &actions = buf.actions;
+    buf.size = 0;
 
-        int finalScore = alphaBeta(gsCopy, depth - 1, alpha, beta);
-        if (gs.getActiveTeam() == 0) {
+    bool isMaxTeam = (gs.getActiveTeam() == 0);
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int bestIndex = -1;
+    int bestScore = 0;
+    int plyIndex = std::min<int>(ctx.ply, ctx.killers.size() - 1);
+    auto &killers = ctx.killers[plyIndex];
+    const int ttRank = std::numeric_limits<int>::max();
+    const int killerRank = ttRank - 2;
+
+    // Search one action, return true if it causes a cutoff.
+    auto search = [&] (const Action &action, int i, int n, int rank) {
+        ++ctx.ply;
+        int finalScore = searchAction(gs, action, depth - 1, alpha, beta, ctx);
+        --ctx.ply;
+        if (ctx.aborted) return true;
+
+        if (bestIndex == -1 ||
+            (isMaxTeam && finalScore > bestScore) ||
+            (!isMaxTeam && finalScore < bestScore))
+        {
+            bestScore = finalScore;
+            bestIndex = i;
+        }
+
+        if (isMaxTeam) {
             alpha = std::max(alpha, finalScore);
-            if (beta <= alpha) break;
         }
         else {
             beta = std::min(beta, finalScore);
-            if (beta <= alpha) break;
         }
+
+        if (beta <= alpha) {
+            ++ctx.stats.cutoffs;
+            if (n == 0) ++ctx.stats.firstCutoffs;
+            if (rank >= killerRank && i != ttIndex) {
+                ++ctx.stats.killerCutoffs;
+            }
+
+            if (i != ttIndex) {
+                ActionKey key{action};
+                if (!(key == killers[0])) {
+                    killers[1] = killers[0];
+                    killers[0] = key;
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    // Try the best action from the last visit first, it's the one most likely
+    // to cause a cutoff.  Skip over the actions before it without building
+    // them, and don't build the rest at all if it does cause a cutoff.
+    bool cutoff = false;
+    Action ttAction;
+    if (ttIndex >= 0) {
+        ActionGenerator gen{gs};
+        while (gen.getIndex() < ttIndex && gen.skip()) {}
+        if (gen.getIndex() == ttIndex && gen.next(ttAction)) {
+            cutoff = search(ttAction, ttIndex, 0, ttRank);
+        }
+        else {
+            ttIndex = -1;
+        }
+    }
+
+    int numActions = 0;
+    if (!cutoff) {
+        ActionGenerator gen{gs};
+        while (buf.generate(gen)) {}
+        numActions = buf.size;
+    }
+
+    // Then the killers, actions that caused a cutoff in a sibling position,
+    // and then the rest by how often they've been best before.  Helper
+    // threads of a parallel search try the rest in a different order from
+    // each other so they don't all search the same subtrees at the same time.
+    auto &history = ctx.history[gs.getActiveUnit().type];
+    auto &rank = buf.rank;
+    auto &order = buf.order;
+    rank.resize(numActions);
+    order.clear();
+    for (int i = 0; i < numActions; ++i) {
+        if (i == ttIndex) continue;
+
+        ActionKey key{actions[i]};
+        if (key == killers[0]) {
+            rank[i] = killerRank + 1;
+        }
+        else if (key == killers[1]) {
+            rank[i] = killerRank;
+        }
+        else {
+            auto h = historyIndex(actions[i]);
+            rank[i] = (h < static_cast<int>(history.size())) ? history[h] : 0;
+        }
+        order.push_back(i);
+    }
+
+    stable_sort(std::begin(order), std::end(order),
+                [&] (int lhs, int rhs) {return rank[lhs] > rank[rhs];});
+    int numOrdered = order.size();
+    if (ctx.helperNum > 0 && numOrdered > 1) {
+        int shift = (ctx.helperNum + depth) % numOrdered;
+        std::rotate(std::begin(order), std::begin(order) + shift,
+                    std::end(order));
+    }
+
+    int first = (ttIndex >= 0) ? 1 : 0;
+    for (int n = 0; n < numOrdered && !cutoff; ++n) {
+        int i = order[n];
+        cutoff = search(actions[i], i, n + first, rank[i]);
+    }
+    if (ctx.aborted) return 0;
+
+    // Credit the best action unless every action failed low, in which case
+    // we don't know which one was best.  Deeper searches are more reliable,
+    // give them more weight.
+    if ((isMaxTeam && bestScore > alphaOrig) ||
+        (!isMaxTeam && bestScore < betaOrig))
+    {
+        const auto &best = (bestIndex == ttIndex) ? ttAction :
+                           actions[bestIndex];
+        auto h = historyIndex(best);
+        if (h >= static_cast<int>(history.size())) {
+            history.resize(h + 1, 0);
+        }
+        history[h] += depth * depth;
+    }
+
+    int result = isMaxTeam ? alpha : beta;
+    TranspositionTable::Entry entry;
+    entry.value = result;
+    entry.depth = depth;
+    entry.bestIndex = bestIndex;
+    if (result <= alphaOrig) {
+        entry.bound = Bound::UPPER;
     }
+    else if (result >= betaOrig) {
+        entry.bound = Bound::LOWER;
+    }
+    else {
+        entry.bound = Bound::EXACT;
+    }
+    ctx.tt.store(hash, entry);
 
-    return (gs.getActiveTeam() == 0) ? alpha : beta;
+    return result;
 }
 
-template <typename F>
-Action bestAction(const GameState &gs, F aiFunc)
+// Value of taking an action, searched to the given depth after it.  With
+// chance nodes on, an attack is a weighted average over its damage outcomes,
+// pruned with Star1: once the outcomes searched so far, plus the best or
+// worst case for the rest, can't land inside (alpha, beta), stop.  Source:
+// Ballard, "The *-minimax search procedure for trees containing chance
+// nodes", Artificial Intelligence 21 (1983).
+int searchAction(GameState &gs, const Action &action, int depth, int alpha,
+                 int beta, SearchContext &ctx)
 {
-    auto possibleActions = gs.getPossibleActions();
-    std::vector<Action> bestActions;
-    int bestScore = std::numeric_limits<int>::min();
+    std::vector<GameState::DamageOutcome> outcomes;
+    if (ctx.chanceNodes) {
+        outcomes = gs.getDamageOutcomes(action);
+    }
+    if (outcomes.size() < 2) {
+        auto undo = gs.applyTurn(action);
+        int value = alphaBeta(gs, depth, alpha, beta, ctx);
+        gs.undoTurn(undo);
+        return value;
+    }
 
-    for (auto &action : possibleActions) {
-        GameState gsCopy{gs};
-        gsCopy.runActionSeq(action);
-        gsCopy.nextTurn();
+    const double lower = -ctx.scoreBound;
+    const double upper = ctx.scoreBound;
+    double total = 0.0;  // probability-weighted values searched so far
+    double probLeft = 1.0;
+    auto outcomeAction = action;
+
+    for (const auto &outcome : outcomes) {
+        probLeft -= outcome.probability;
 
-        int scoreDiff = aiFunc(gsCopy);
-        if (gs.getActiveTeam() != 0) scoreDiff = -scoreDiff;
+        // Values of this outcome that would decide the result regardless of
+        // the outcomes still to come.
+        double failLow = (alpha - total - upper * probLeft) /
+            outcome.probability;
+        double failHigh = (beta - total - lower * probLeft) /
+            outcome.probability;
+        if (failLow >= upper) return alpha;
+        if (failHigh <= lower) return beta;
+        int childAlpha = std::max(floor(failLow), lower);
+        int childBeta = std::min(ceil(failHigh), upper);
 
-        if (scoreDiff > bestScore) {
-            bestScore = scoreDiff;
-            std::vector<Action> betterAction(1, action);
+        outcomeAction.damage = outcome.damage;
+        outcomeAction.fixedDamage = true;
+        auto undo = gs.applyTurn(outcomeAction);
+        int value = alphaBeta(gs, depth, childAlpha, childBeta, ctx);
+        gs.undoTurn(undo);
+        if (ctx.aborted) return 0;
+
+        value = bound(value, -ctx.scoreBound, ctx.scoreBound);
+        if (value <= failLow) return alpha;
+        if (value >= failHigh) return beta;
+        total += outcome.probability * value;
+    }
+
+    return nearbyint(total);
+}
+
+// Choose among the actions with the highest score.  Scores are from the point
+// of view of the active team.
+Action pickBest(const GameState &gs, const std::vector<Action> &actions,
+                const std::vector<int> &scores)
+{
+    assert(actions.size() == scores.size());
+    std::vector<Action> bestActions;
+    int bestScore = std::numeric_limits<int>::min();
+
+    for (auto i = 0u; i < actions.size(); ++i) {
+        if (scores[i] > bestScore) {
+            bestScore = scores[i];
+            std::vector<Action> betterAction(1, actions[i]);
             bestActions.swap(betterAction);
         }
-        else if (scoreDiff == bestScore) {
-            bestActions.push_back(action);
+        else if (scores[i] == bestScore) {
+            bestActions.push_back(actions[i]);
         }
     }
     assert(!bestActions.empty());
@@ -126,20 +527,247 @@ Action bestAction(const GameState &gs, F aiFunc)
     // deterministic.
     if (best.type != ActionType::EFFECT) {
         best.damage = 0;
+        best.fixedDamage = false;
     }
     return best;
 }
 
-Action minimax(const GameState &gs, int searchDepth)
+template <typename F>
+Action bestAction(GameState &gs, F aiFunc)
+{
+    auto possibleActions = gs.getPossibleActions();
+    std::vector<int> scores;
+    bool isMaxTeam = (gs.getActiveTeam() == 0);
+
+    for (auto &action : possibleActions) {
+        auto undo = gs.applyTurn(action);
+        int scoreDiff = aiFunc(gs);
+        gs.undoTurn(undo);
+
+        if (!isMaxTeam) scoreDiff = -scoreDiff;
+        scores.push_back(scoreDiff);
+    }
+
+    return pickBest(gs, possibleActions, scores);
+}
+
+// Search one root action and return its score from the point of view of the
+// active team.  Actions that can't reach 'bestScore' may be cut off and get
+// an upper bound instead of an exact score, which is all pickBest() needs to
+// rule them out.  Raise 'bestScore' if this action beats it.
+int searchRootAction(GameState &gs, const Action &action, int depth,
+                     std::atomic<int> &bestScore, SearchContext &ctx)
+{
+    const int minScore = std::numeric_limits<int>::min();
+    const int maxScore = std::numeric_limits<int>::max();
+    bool isMaxTeam = (gs.getActiveTeam() == 0);
+
+    // Ties with the best score must be exact, anything lower can be cut off.
+    int best = bestScore;
+    int lowerBound = (best == minScore) ? minScore : best - 1;
+    int alpha = minScore;
+    int beta = maxScore;
+    if (isMaxTeam) {
+        alpha = lowerBound;
+    }
+    else if (lowerBound != minScore) {
+        beta = -lowerBound;
+    }
+
+    int scoreDiff = searchAction(gs, action, depth, alpha, beta, ctx);
+    if (ctx.aborted) return minScore;
+
+    int score = isMaxTeam ? scoreDiff : -scoreDiff;
+    while (score > best && !bestScore.compare_exchange_weak(best, score)) {
+    }
+    return score;
+}
 
+// Search every root action to the given depth, sharing the actions among the
+// workers in 'searchOrder' order.  Each worker gets its own thread and copy of
+// the game state.  Workers share the best score found so far to narrow the
+// search of the remaining actions.  Return false if the search ran out of
+// time.
+bool searchRoot(const GameState &gs, const std::vector<Action> &actions,
+                const std::vector<int> &searchOrder, int depth,
+                std::vector<SearchContext> &workers, std::vector<int> &scores)
 {
-    auto abSearch = [&] (const GameState &gs) {
-        return alphaBeta(gs,
-                         searchDepth,
-                         std::numeric_limits<int>::min(),
-                         std::numeric_limits<int>::max());
+    int numActions = actions.size();
+    std::atomic<int> nextAction{0};
+    std::atomic<int> bestScore{std::numeric_limits<int>::min()};
+
+    auto runWorker = [&] (SearchContext &ctx) {
+        GameState gsWorker{gs};
+
+        for (int n = nextAction++; n < numActions; n = nextAction++) {
+            int i = searchOrder[n];
+            scores[i] = searchRootAction(gsWorker, actions[i], depth,
+                                         bestScore, ctx);
+            if (ctx.aborted) return;
+        }
     };
-    return bestAction(gs, abSearch);
+
+    boost::thread_group threads;
+    for (auto w = 1u; w < workers.size(); ++w) {
+        auto &ctx = workers[w];
+        threads.create_thread([&] {runWorker(ctx);});
+    }
+    runWorker(workers[0]);
+    threads.join_all();
+
+    return std::none_of(std::begin(workers), std::end(workers),
+                        [] (const SearchContext &ctx) {return ctx.aborted;});
+}
+
+// One search context per thread (one per core if 'numThreads' is 0), but no
+// more than there are root actions.  The workers all share one table.
+std::vector<SearchContext> makeWorkers(TranspositionTable &tt, int numActions,
+                                       int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = boost::thread::hardware_concurrency();
+    }
+    numThreads = bound(numThreads, 1, numActions);
+
+    std::vector<SearchContext> workers;
+    workers.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(tt);
+    }
+    return workers;
+}
+
+Action minimax(const GameState &gs, int searchDepth, int numThreads)
+{
+    auto possibleActions = gs.getPossibleActions();
+    int numActions = possibleActions.size();
+    std::vector<int> scores(numActions, 0);
+    std::vector<int> searchOrder(numActions);
+    std::iota(std::begin(searchOrder), std::end(searchOrder), 0);
+
+    TranspositionTable tt{TT_SIZE_LOG2};
+    auto workers = makeWorkers(tt, numActions, numThreads);
+    searchRoot(gs, possibleActions, searchOrder, searchDepth, workers, scores);
+    return pickBest(gs, possibleActions, scores);
+}
+
+// Search to depth 1, 2, 3, ... until time runs out and return the best action
+// from the last search that finished.  Each search starts with the best
+// actions found by the one before, both at the root and in the table.
+Action iterativeDeepening(const GameState &gs, double timeLimit_sec,
+                          bool chanceNodes, SearchStats *stats, int numThreads)
+{
+    auto possibleActions = gs.getPossibleActions();
+    int numActions = possibleActions.size();
+    std::vector<int> scores(numActions, 0);
+    std::vector<int> searchOrder(numActions);
+    std::iota(std::begin(searchOrder), std::end(searchOrder), 0);
+
+    TranspositionTable tt{TT_SIZE_LOG2};
+    auto workers = makeWorkers(tt, numActions, numThreads);
+    auto timeLimit = std::chrono::duration_cast<SearchClock::duration>(
+        std::chrono::duration<double>(timeLimit_sec));
+    auto deadline = SearchClock::now() + timeLimit;
+    // The winning bonus in alphaBeta() multiplies scores by 10.
+    auto maxScore = gs.getMaxScore();
+    for (auto &ctx : workers) {
+        ctx.deadline = deadline;
+        ctx.chanceNodes = chanceNodes;
+        ctx.scoreBound = 10 * std::max(maxScore[0], maxScore[1]);
+    }
+
+    for (int depth = 1; depth <= MAX_SEARCH_DEPTH && numActions > 1; ++depth) {
+        // Always finish the first search so we have something to return.
+        for (auto &ctx : workers) {
+            ctx.hasDeadline = (depth > 1);
+        }
+
+        std::vector<int> depthScores(numActions, 0);
+        if (!searchRoot(gs, possibleActions, searchOrder, depth, workers,
+                        depthScores))
+        {
+            break;
+        }
+
+        scores.swap(depthScores);
+        stable_sort(std::begin(searchOrder), std::end(searchOrder),
+                    [&] (int lhs, int rhs) {return scores[lhs] > scores[rhs];});
+        if (stats) stats->depth = depth;
+    }
+
+    if (stats) {
+        for (const auto &ctx : workers) {
+            *stats += ctx.stats;
+        }
+    }
+    return pickBest(gs, possibleActions, scores);
+}
+
+// Lazy SMP: every thread searches the whole tree, sharing one table.  The
+// helper threads search in a different order, and half of them one ply
+// deeper, so the main thread finds most of its subtrees already in the table.
+// Only the main thread's scores are used.
+Action lazySmp(const GameState &gs, int numThreads, double timeLimit_sec,
+               int maxDepth, SearchStats *stats)
+{
+    auto possibleActions = gs.getPossibleActions();
+    int numActions = possibleActions.size();
+    std::vector<int> scores(numActions, 0);
+    std::vector<int> searchOrder(numActions);
+    std::iota(std::begin(searchOrder), std::end(searchOrder), 0);
+
+    TranspositionTable tt{TT_SIZE_LOG2};
+    SearchContext ctx{tt};
+    auto timeLimit = std::chrono::duration_cast<SearchClock::duration>(
+        std::chrono::duration<double>(timeLimit_sec));
+    ctx.deadline = SearchClock::now() + timeLimit;
+    GameState gsMain{gs};
+
+    for (int depth = 1; depth <= maxDepth && numActions > 1; ++depth) {
+        // Always finish the first search so we have something to return.
+        ctx.hasDeadline = (depth > 1);
+
+        // Helpers run until the main thread is done with this depth.
+        std::atomic<bool> stop{false};
+        boost::thread_group helpers;
+        for (int h = 1; h < numThreads; ++h) {
+            helpers.create_thread([&, h] {
+                SearchContext helperCtx{tt, h};
+                helperCtx.stop = &stop;
+                GameState gsHelper{gs};
+                std::atomic<int> helperBest{std::numeric_limits<int>::min()};
+
+                std::vector<int> helperOrder{searchOrder};
+                std::rotate(std::begin(helperOrder),
+                            std::begin(helperOrder) + h % numActions,
+                            std::end(helperOrder));
+                for (auto i : helperOrder) {
+                    searchRootAction(gsHelper, possibleActions[i],
+                                     depth + h % 2, helperBest, helperCtx);
+                    if (helperCtx.aborted) return;
+                }
+            });
+        }
+
+        std::vector<int> depthScores(numActions, 0);
+        std::atomic<int> bestScore{std::numeric_limits<int>::min()};
+        for (auto i : searchOrder) {
+            depthScores[i] = searchRootAction(gsMain, possibleActions[i],
+                                              depth, bestScore, ctx);
+            if (ctx.aborted) break;
+        }
+        stop = true;
+        helpers.join_all();
+        if (ctx.aborted) break;
+
+        scores.swap(depthScores);
+        stable_sort(std::begin(searchOrder), std::end(searchOrder),
+                    [&] (int lhs, int rhs) {return scores[lhs] > scores[rhs];});
+        if (stats) stats->depth = depth;
+    }
+
+    if (stats) *stats += ctx.stats;
+    return pickBest(gs, possibleActions, scores);
 }
 
 Action aiNaive(GameState gs)
@@ -148,26 +776,61 @@ Action aiNaive(GameState gs)
     return bestAction(gs, noLookAhead);
 }
 
-Action aiBetter(GameState gs)
+Action aiBetter(GameState gs, int numThreads)
+{
+    gs.setSimMode();
+    return minimax(gs, 4, numThreads);
+}
+
+Action aiBest(GameState gs, double timeLimit_sec, SearchStats *stats,
+              int numThreads)
 {
     gs.setSimMode();
-    return minimax(gs, 4);
+    return iterativeDeepening(gs, timeLimit_sec, false, stats, numThreads);
 }
 
-Action aiBest(GameState gs)
+Action aiExpectimax(GameState gs, double timeLimit_sec, SearchStats *stats,
+                    int numThreads)
 {
     gs.setSimMode();
+    return iterativeDeepening(gs, timeLimit_sec, true, stats, numThreads);
+}
 
-    auto start_sec = std::chrono::system_clock::now();
-    auto action = minimax(gs, 6);
-    auto end_sec = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed_sec = end_sec - start_sec;
+Action aiParallel(GameState gs, int numThreads, double timeLimit_sec,
+                  SearchStats *stats, int maxDepth)
+{
+    if (numThreads <= 0) {
+        numThreads = std::max<int>(boost::thread::hardware_concurrency(), 1);
+    }
+    if (maxDepth <= 0) {
+        maxDepth = MAX_SEARCH_DEPTH;
+    }
 
-    // Increasing the search depth causes a ~10x increase in runtime.
-    // TODO: research the killer heuristic
-    if (elapsed_sec.count() < 0.25) {
-        action = minimax(gs, 8);
+    gs.setSimMode();
+    return lazySmp(gs, numThreads, timeLimit_sec,
+                   std::min(maxDepth, MAX_SEARCH_DEPTH), stats);
+}
+
+Action aiMcts(GameState gs, MctsTree &tree, double timeLimit_sec,
+              int maxPlayouts)
+{
+    assert(timeLimit_sec > 0 || maxPlayouts > 0);
+    gs.setSimMode(true);
+
+    // The tree only helps if the battle reached one of its positions,
+    // otherwise setRoot() starts over.
+    tree.setRoot(gs);
+
+    auto timeLimit = std::chrono::duration_cast<SearchClock::duration>(
+        std::chrono::duration<double>(timeLimit_sec));
+    auto deadline = SearchClock::now() + timeLimit;
+    for (int i = 0; maxPlayouts <= 0 || i < maxPlayouts; ++i) {
+        // Always run at least one playout so we have something to return.
+        if (i > 0 && timeLimit_sec > 0 && SearchClock::now() >= deadline) {
+            break;
+        }
+        tree.runPlayout(gs);
     }
 
-    return action;
+    return tree.getBestAction();
 }
@@ -13,11 +13,56 @@
 #ifndef AI_H
 #define AI_H
 
+#include <iosfwd>
+
 class Action;
 class GameState;
+class MctsTree;
+
+// Counters showing how well the search ordered its actions.  The more
+// cutoffs happen on the first action tried, the smaller the tree.
+struct SearchStats
+{
+    int depth;  // deepest search completed
+    unsigned long nodes;  // positions whose actions were searched
+    unsigned long cutoffs;
+    unsigned long firstCutoffs;
+    unsigned long killerCutoffs;
+
+    SearchStats();
+    SearchStats & operator+=(const SearchStats &rhs);
+};
+
+std::ostream & operator<<(std::ostream &ostr, const SearchStats &stats);
 
+// The searches below split the root actions among 'numThreads' threads, one
+// per core if 0.  Callers that already run several searches at once (like
+// battles spread over threads by estimateBattle()) should pass 1.
 Action aiNaive(GameState gs);
-Action aiBetter(GameState gs);
-Action aiBest(GameState gs);
+Action aiBetter(GameState gs, int numThreads = 0);
+
+// Search as deeply as possible in the time allowed.  Add to 'stats' if given.
+Action aiBest(GameState gs, double timeLimit_sec = 0.5,
+              SearchStats *stats = nullptr, int numThreads = 0);
+
+// Same, but plan against every likely damage roll of each attack instead of
+// just the average.  Slower, so it doesn't search as deeply.
+Action aiExpectimax(GameState gs, double timeLimit_sec = 0.5,
+                    SearchStats *stats = nullptr, int numThreads = 0);
+
+// Same as aiBest(), but with every thread searching the whole tree together
+// (one per core if 'numThreads' is 0).  Stop after 'maxDepth' plies if it's
+// more than 0, for results that don't depend on how fast the machine is.
+Action aiParallel(GameState gs, int numThreads, double timeLimit_sec = 0.5,
+                  SearchStats *stats = nullptr, int maxDepth = 0);
+
+// Monte Carlo Tree Search with random damage rolls.  Stop at the time limit or
+// after the given number of playouts, whichever comes first (zero or less for
+// no limit, but set at least one).  The caller owns the tree, so keep one per
+// player and pass it back in each turn: the search picks up where the last
+// one left off if the battle reached one of the positions in it.  Only one
+// search may use a tree at a time.
+Action aiMcts(GameState gs, MctsTree &tree, double timeLimit_sec = 0.5,
+              int maxPlayouts = 0);
 
 #endif
@@ -11,13 +11,72 @@
     See the COPYING.txt file for more details.
 */
 #include "algo.h"
+#include "boost/thread/tss.hpp"
+#include <atomic>
 #include <cctype>
 #include <ctime>
 
-std::minstd_rand & randomGenerator()
+namespace
 {
-    static std::minstd_rand gen(static_cast<unsigned int>(std::time(nullptr)));
-    return gen;
+    // Step between counter values, from splitmix64.  Any odd constant
+    // visits every counter value before repeating.
+    const uint64_t COUNTER_STEP = 0x9e3779b97f4a7c15ULL;
+
+    boost::thread_specific_ptr<RandomStream> threadGenerator;
+    std::atomic<uint64_t> processSeed{static_cast<uint64_t>(std::time(nullptr))};
+    std::atomic<uint64_t> numGenerators{0};
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+    : key_{0},
+    counter_{0}
+{
+    this->seed(seed, stream);
+}
+
+void RandomStream::seed(uint64_t seed, uint64_t stream)
+{
+    key_ = hashMix(hashMix(seed) ^ stream);
+    counter_ = 0;
+}
+
+RandomStream::result_type RandomStream::operator()()
+{
+    return hashMix(key_ + COUNTER_STEP * counter_++);
+}
+
+void RandomStream::discard(unsigned long long n)
+{
+    counter_ += n;
+}
+
+uint64_t RandomStream::getCount() const
+{
+    return counter_;
+}
+
+RandomStream & randomGenerator()
+{
+    // Give each thread its own generator so simulations running in parallel
+    // don't share (or race on) the same one.
+    if (!threadGenerator.get()) {
+        threadGenerator.reset(new RandomStream(processSeed, numGenerators++));
+    }
+    return *threadGenerator;
+}
+
+void setRandomSeed(uint64_t seed)
+{
+    processSeed = seed;
+    randomGenerator().seed(seed, 0);
+}
+
+uint64_t hashMix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
 }
 
 std::string to_upper(std::string str)
@@ -14,6 +14,7 @@
 #define ALGO_H
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <random>
@@ -22,7 +23,7 @@
 template <class Container, class T>
 bool contains(const Container &c, const T &elem)
 {
-    return find(std::begin(c), std::end(c), elem) != std::end(c);
+    return std::find(std::begin(c), std::end(c), elem) != std::end(c);
 }
 
 template <class T, class U, class V>
@@ -39,7 +40,42 @@ std::unique_ptr<T> make_unique(Args &&... args)
     return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
-std::minstd_rand & randomGenerator();
+// Counter-based random number generator.  The nth number of a stream is a
+// hash of (seed, stream id, n), so any stream can be recreated exactly, and
+// streams with different ids don't overlap in practice.  Give each parallel
+// simulation its own stream to make it reproducible no matter which thread
+// runs it.  Works with the <random> distributions.
+class RandomStream
+{
+public:
+    using result_type = uint64_t;
+
+    explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0);
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    result_type operator()();
+    void discard(unsigned long long n);
+
+    // Numbers drawn so far.
+    uint64_t getCount() const;
+
+    static constexpr result_type min() {return 0;}
+    static constexpr result_type max() {return UINT64_MAX;}
+
+private:
+    uint64_t key_;
+    uint64_t counter_;
+};
+
+// Each thread has its own generator.  Until it's seeded, it's a stream of
+// the process-wide seed (from the clock by default), one stream per thread in
+// the order threads first ask for it.
+RandomStream & randomGenerator();
+
+// Replace the process-wide seed and restart the calling thread's generator at
+// stream 0 of it.  Threads that haven't drawn a number yet will use the new
+// seed too.
+void setRandomSeed(uint64_t seed);
 
 template <class Container>
 typename Container::const_iterator randomElem(const Container &c)
@@ -52,6 +88,10 @@ typename Container::const_iterator randomElem(const Container &c)
     return std::next(iter, index);
 }
 
+// Scramble the bits of a 64-bit value (splitmix64 finalizer).  Chaining calls
+// to this produces the pseudo-random keys used for Zobrist hashing.
+uint64_t hashMix(uint64_t x);
+
 std::string to_upper(std::string str);
 std::string to_lower(std::string str);
 
@@ -14,17 +14,21 @@
 #include "Anim.h"
 #include "Battlefield.h"
 #include "CommanderView.h"
+#include "EffectArt.h"
 #include "GameState.h"
 #include "HexGrid.h"
 #include "LogView.h"
+#include "Mcts.h"
 #include "UnitView.h"
 #include "Spells.h"
 #include "Unit.h"
+#include "UnitArt.h"
 #include "UnitType.h"
 #include "ai.h"
 #include "algo.h"
 #include "hex_utils.h"
 #include "json_utils.h"
+#include "scenario.h"
 #include "sdl_helper.h"
 
 #include "boost/lexical_cast.hpp"
@@ -60,7 +64,6 @@ namespace
     SDL_Rect unitWindow1 = {0, 235, 200, pHexSize + 60};
     SDL_Rect unitWindow2 = {498, 235, 200, pHexSize + 60};
     SDL_Rect logWindow = {205, 365, 288, 60};
-    std::unordered_map<std::string, int> mapUnitPos;
     UnitTypeMap unitRef;
     std::deque<std::unique_ptr<Anim>> anims;
     bool actionTaken = false;
@@ -71,55 +74,10 @@ namespace
     AiState aiState = AiState::IDLE;
     boost::future<Action> aiAction;
     bool playerIsHuman[] = {true, true};
+    bool playerUsesMcts[] = {false, false};
+    MctsTree mctsTrees[2];  // one per player, kept from turn to turn
     SdlSurface unitPopup;
     SDL_Rect popupWindow;
-
-    // Unit placement on the grid.
-    // team 1 on the left, team 2 on the right
-    const Point unitPos[] = {{1,0}, {1,1}, {1,2}, {1,3},  // team 1 row 1
-                             {0,1}, {0,2}, {0,3},         // team 1 row 2
-                             {3,0}, {3,1}, {3,2}, {3,3},  // team 2 row 1
-                             {4,1}, {4,2}, {4,3}};        // team 2 row 2
-
-    // Map unit position strings used by JSON data to 'unitPos' array indexes.
-    void translateUnitPos()
-    {
-        mapUnitPos.emplace("t1p1", 0);
-        mapUnitPos.emplace("t1p2", 1);
-        mapUnitPos.emplace("t1p3", 2);
-        mapUnitPos.emplace("t1p4", 3);
-        mapUnitPos.emplace("t1p5", 4);
-        mapUnitPos.emplace("t1p6", 5);
-        mapUnitPos.emplace("t1p7", 6);
-        mapUnitPos.emplace("t2p1", 7);
-        mapUnitPos.emplace("t2p2", 8);
-        mapUnitPos.emplace("t2p3", 9);
-        mapUnitPos.emplace("t2p4", 10);
-        mapUnitPos.emplace("t2p5", 11);
-        mapUnitPos.emplace("t2p6", 12);
-        mapUnitPos.emplace("t2p7", 13);
-    }
-
-    void initBattleGrid()
-    {
-        grid = make_unique<HexGrid>(5, 5);
-        grid->erase(0, 0);
-        grid->erase(0, 4);
-        grid->erase(1, 4);
-        grid->erase(3, 4);
-        grid->erase(4, 0);
-        grid->erase(4, 4);
-    }
-
-    const UnitType * getUnitType(const std::string &name)
-    {
-        auto iter = unitRef.find(name);
-        if (iter != std::end(unitRef)) {
-            return &iter->second;
-        }
-
-        return nullptr;
-    }
 }
 
 // Human player's function - determine what action the active unit can take if
@@ -231,7 +189,7 @@ void animateAction(const Action &action)
         unit.face = getFacing(hSrc, hTgt, unit.face);
         auto animShooter = make_unique<AnimRanged>(unit);
 
-        auto animShot = make_unique<AnimProjectile>(unit.type->projectile,
+        auto animShot = make_unique<AnimProjectile>(unit.type->art->projectile,
              hSrc, hTgt, animShooter->getShotTime());
 
         defender.face = getFacing(hTgt, hSrc, defender.face);
@@ -532,23 +490,6 @@ void handleKeyPress(const SDL_KeyboardEvent &event)
     actionTaken = true;
 }
 
-bool parseUnits(const rapidjson::Document &doc)
-{
-    bool unitAdded = false;
-    for (auto i = doc.MemberBegin(); i != doc.MemberEnd(); ++i) {
-        if (!i->value.IsObject()) {
-            std::cerr << "units: skipping id '" << i->name.GetString() <<
-                "'\n";
-            continue;
-        }
-
-        unitRef.emplace(i->name.GetString(), UnitType(i->value));
-        unitAdded = true;
-    }
-
-    return unitAdded;
-}
-
 // Create a drawable entity for the size of a unit.  Return its id.
 int createUnitLabel(int num, int team, Point hex)
 {
@@ -560,83 +501,41 @@ int createUnitLabel(int num, int team, Point hex)
     return id;
 }
 
-void parseOptions(const rapidjson::Value &json)
+// Add the scenario's units to the game and the battlefield.  Return false if
+// there's nothing to fight with.
+bool loadScenario(const rapidjson::Document &doc)
 {
-    if (json.HasMember("players")) {
-        const rapidjson::Value &players = json["players"];
-        for (auto i = 0u; i < players.Size(); ++i) {
-            if (to_lower(players[i].GetString()) == "ai") {
-                playerIsHuman[i] = false;
-            }
-        }
+    auto scenario = parseScenario(doc, unitRef, *grid);
+    if (scenario.units.empty()) {
+        std::cerr << "Error: no units in scenario" << std::endl;
+        return false;
     }
-}
-
-void parseScenario(const rapidjson::Document &doc)
-{
-    for (auto i = doc.MemberBegin(); i != doc.MemberEnd(); ++i) {
-        if (!i->value.IsObject()) {
-            std::cerr << "scenario: skipping unit at position '"
-                << i->name.GetString() << "'\n";
-            continue;
-        }
-
-        // Compute battlefield position from location id.
-        std::string posStr = i->name.GetString();
-        auto posIter = mapUnitPos.find(posStr);
-        if (posIter == std::end(mapUnitPos)) {
-            if (posStr == "options") {
-                parseOptions(i->value);
-            }
-            else if (posStr == "cmdr1") {
-                gs->setCommander(Commander(i->value), 0);
-            }
-            else if (posStr == "cmdr2") {
-                gs->setCommander(Commander(i->value), 1);
-            }
-            else {
-                std::cerr << "scenario: skipping unit at position '"
-                    << i->name.GetString() << "'\n";
-            }
-            continue;
-        }
-        int posIdx = posIter->second;
-        const auto &bfHex = unitPos[posIdx];
-
-        const auto &json = i->value;
 
-        // Ensure we recognize the unit id.
-        std::string name;
-        if (json.HasMember("id")) {
-            name = json["id"].GetString();
-        }
-        const auto unitType = getUnitType(name);
-        if (!unitType) {
-            std::cerr << "scenario: skipping unit with unknown id '" <<
-                unitType << "'\n";
-            continue;
-        }
+    for (int i = 0; i < 2; ++i) {
+        gs->setCommander(scenario.commanders[i], i);
+        playerIsHuman[i] = (scenario.players[i] == Player::HUMAN);
+        playerUsesMcts[i] = (scenario.players[i] == Player::MCTS);
+    }
 
-        Unit newUnit(*unitType);
-        newUnit.team = (posIdx < 7) ? 0 : 1;
-        newUnit.aHex = grid->aryFromHex(bfHex);
-        newUnit.face = (newUnit.team == 0) ? Facing::RIGHT : Facing::LEFT;
-        if (json.HasMember("num")) {
-            newUnit.num = json["num"].GetInt();
+    for (auto &newUnit : scenario.units) {
+        auto bfHex = grid->hexFromAry(newUnit.aHex);
+        if (newUnit.num > 0) {
             newUnit.labelId = createUnitLabel(newUnit.num, newUnit.team, bfHex);
         }
 
         SdlSurface img;
         if (newUnit.team == 0) {
-            img = newUnit.type->baseImg[0];
+            img = newUnit.type->art->baseImg[0];
         }
         else {
-            img = newUnit.type->reverseImg[1];
+            img = newUnit.type->art->reverseImg[1];
         }
 
         newUnit.entityId = bf->addEntity(bfHex, img, ZOrder::CREATURE);
         gs->addUnit(newUnit);
     }
+
+    return true;
 }
 
 bool checkNewRound()
@@ -711,6 +610,10 @@ Action callNaiveAI()
 
 Action callBestAI()
 {
+    if (playerUsesMcts[gs->getActiveTeam()]) {
+        return aiMcts(*gs, mctsTrees[gs->getActiveTeam()]);
+    }
+
     return aiBest(*gs);
 }
 
@@ -736,7 +639,7 @@ extern "C" int SDL_main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    initBattleGrid();
+    grid = makeBattleGrid();
     bf = make_unique<Battlefield>(bfWindow, *grid);
     Anim::setBattlefield(*bf);
     atexit([] {bf.reset();});
@@ -748,29 +651,23 @@ extern "C" int SDL_main(int argc, char *argv[])
     // Note: atexits ensure SDL resources are cleaned up before the subsystems
     // are torn down.
 
-    if (!initEffectCache("effects.json")) {
-        std::cerr << "Warning: no effect definitions loaded" << std::endl;
-    }
-    if (!initSpellCache("spells.json")) {
-        std::cerr << "Warning: no spell definitions loaded" << std::endl;
-    }
-
-    rapidjson::Document unitsDoc;
-    if (!jsonParse("units.json", unitsDoc)) {
+    if (!loadGameData(unitRef)) {
         return EXIT_FAILURE;
     }
-    if (!parseUnits(unitsDoc)) {
-        std::cerr << "Error: no unit definitions loaded" << std::endl;
+    if (!loadUnitArt(unitRef)) {
         return EXIT_FAILURE;
     }
-
-    translateUnitPos();
+    if (!initEffectArt("effects.json")) {
+        std::cerr << "Warning: no effect art loaded" << std::endl;
+    }
 
     rapidjson::Document scenario;
     if (!jsonParse(getScenario(argc, argv), scenario)) {
         return EXIT_FAILURE;
     }
-    parseScenario(scenario);
+    if (!loadScenario(scenario)) {
+        return EXIT_FAILURE;
+    }
 
     logv = make_unique<LogView>(logWindow);
     CommanderView cView1{cmdrWindow1, 0, *gs};
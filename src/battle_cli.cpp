@@ -0,0 +1,360 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "Action.h"
+#include "GameState.h"
+#include "HexGrid.h"
+#include "Mcts.h"
+#include "ai.h"
+#include "algo.h"
+#include "estimator.h"
+#include "json_utils.h"
+#include "scenario.h"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+// Run AI-vs-AI battles without a display and report how each side did.
+//
+// usage: battle_cli [options] <scenario.json>
+//   -n <battles>    number of battles to run (default 100)
+//   -1 <ai>         AI for team 1: naive, better, best, expectimax,
+//                   parallel, mcts
+//   -2 <ai>         AI for team 2 (both default to best)
+//   -t <seconds>    time limit per AI move (default 0.5)
+//   -j <threads>    battles to run at once (default 1, 0 for one per core)
+//   -s <seed>       random seed (default: current time)
+//   --search-threads <threads>
+//                   threads per AI search, 0 for one per core (default 0
+//                   when running one battle at a time, 1 otherwise)
+//   --stats         also report search statistics for each team
+
+namespace
+{
+    using BattleClock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        const char *scenarioFile;
+        int numBattles;
+        std::array<std::string, 2> ai;
+        double timeLimit_sec;
+        int numThreads;
+        int searchThreads;  // -1 to pick based on numThreads
+        bool showStats;
+        bool hasSeed;
+        unsigned seed;
+
+        Options()
+            : scenarioFile{nullptr},
+            numBattles{100},
+            ai{{"best", "best"}},
+            timeLimit_sec{0.5},
+            numThreads{1},
+            searchThreads{-1},
+            showStats{false},
+            hasSeed{false},
+            seed{0}
+        {
+        }
+    };
+
+    // Time spent choosing moves, summed over every battle thread.
+    struct AiTimer
+    {
+        std::atomic<long long> elapsed_usec;
+        std::atomic<int> moves;
+
+        AiTimer() : elapsed_usec{0}, moves{0} {}
+    };
+
+    // Search statistics, summed over every battle thread.  The total keeps
+    // the deepest search of any move, so also track the average.
+    struct AiStats
+    {
+        boost::mutex mutex;
+        SearchStats total;
+        long long sumDepth;
+        int searches;
+
+        AiStats() : mutex{}, total{}, sumDepth{0}, searches{0} {}
+
+        void add(const SearchStats &stats)
+        {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            total += stats;
+            sumDepth += stats.depth;
+            ++searches;
+        }
+    };
+
+    void usage()
+    {
+        std::cerr << "usage: battle_cli [-n battles] [-1 ai] [-2 ai] "
+            "[-t seconds] [-j threads] [-s seed]\n"
+            "                  [--search-threads threads] [--stats] "
+            "<scenario.json>\n"
+            "    ai is one of: naive, better, best, expectimax, parallel, "
+            "mcts\n";
+    }
+
+    template <typename T>
+    bool parseNumber(const char *str, T &value)
+    {
+        std::istringstream istr{str};
+        istr >> value;
+        return istr && istr.eof();
+    }
+
+    bool parseArgs(int argc, char *argv[], Options &opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--stats") {
+                opts.showStats = true;
+            }
+            else if (arg == "--search-threads" && i + 1 < argc) {
+                const char *value = argv[++i];
+                if (!parseNumber(value, opts.searchThreads) ||
+                    opts.searchThreads < 0)
+                {
+                    std::cerr << "bad value for " << arg << ": " << value <<
+                        '\n';
+                    return false;
+                }
+            }
+            else if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc) {
+                const char *value = argv[++i];
+                bool ok = true;
+                switch (arg[1]) {
+                    case 'n':
+                        ok = parseNumber(value, opts.numBattles);
+                        break;
+                    case '1':
+                        opts.ai[0] = to_lower(value);
+                        break;
+                    case '2':
+                        opts.ai[1] = to_lower(value);
+                        break;
+                    case 't':
+                        ok = parseNumber(value, opts.timeLimit_sec);
+                        break;
+                    case 'j':
+                        ok = parseNumber(value, opts.numThreads) &&
+                            opts.numThreads >= 0;
+                        break;
+                    case 's':
+                        ok = parseNumber(value, opts.seed);
+                        opts.hasSeed = true;
+                        break;
+                    default:
+                        return false;
+                }
+                if (!ok) {
+                    std::cerr << "bad value for " << arg << ": " << value <<
+                        '\n';
+                    return false;
+                }
+            }
+            else if (!opts.scenarioFile && arg[0] != '-') {
+                opts.scenarioFile = argv[i];
+            }
+            else {
+                return false;
+            }
+        }
+
+        return opts.scenarioFile != nullptr && opts.numBattles > 0;
+    }
+
+    // Searches use 'searchThreads' threads each (0 for one per core) and add
+    // what they did to 'stats'.
+    AiFunc getAi(const std::string &name, double timeLimit_sec,
+                 int searchThreads, AiStats &stats)
+    {
+        auto statsPtr = &stats;
+        if (name == "naive") {
+            return [] (const GameState &gs) {return aiNaive(gs);};
+        }
+        if (name == "better") {
+            return [=] (const GameState &gs) {
+                return aiBetter(gs, searchThreads);
+            };
+        }
+        if (name == "best") {
+            return [=] (const GameState &gs) {
+                SearchStats moveStats;
+                auto action = aiBest(gs, timeLimit_sec, &moveStats,
+                                     searchThreads);
+                statsPtr->add(moveStats);
+                return action;
+            };
+        }
+        if (name == "expectimax") {
+            return [=] (const GameState &gs) {
+                SearchStats moveStats;
+                auto action = aiExpectimax(gs, timeLimit_sec, &moveStats,
+                                           searchThreads);
+                statsPtr->add(moveStats);
+                return action;
+            };
+        }
+        if (name == "parallel") {
+            return [=] (const GameState &gs) {
+                SearchStats moveStats;
+                auto action = aiParallel(gs, searchThreads, timeLimit_sec,
+                                         &moveStats);
+                statsPtr->add(moveStats);
+                return action;
+            };
+        }
+        if (name == "mcts") {
+            // Battles run on several threads, each one keeps its own tree
+            // from one move to the next.
+            auto trees = std::make_shared<
+                boost::thread_specific_ptr<MctsTree>>();
+            return [=] (const GameState &gs) {
+                if (!trees->get()) {
+                    trees->reset(new MctsTree);
+                }
+                return aiMcts(gs, *trees->get(), timeLimit_sec);
+            };
+        }
+        return {};
+    }
+
+    AiFunc timed(AiFunc ai, AiTimer &timer)
+    {
+        return [ai, &timer] (const GameState &gs) {
+            auto start = BattleClock::now();
+            auto action = ai(gs);
+            auto elapsed = BattleClock::now() - start;
+            timer.elapsed_usec += std::chrono::duration_cast<
+                std::chrono::microseconds>(elapsed).count();
+            ++timer.moves;
+            return action;
+        };
+    }
+
+    void printEstimate(const Estimate &est, double scale)
+    {
+        std::cout << est.value * scale << " (" << est.low * scale << '-' <<
+            est.high * scale << ')';
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    // When several battles run at once, each search gets one thread so the
+    // battles don't fight over the cores.
+    int searchThreads = opts.searchThreads;
+    if (searchThreads < 0) {
+        searchThreads = (opts.numThreads == 1) ? 0 : 1;
+    }
+
+    std::array<AiTimer, 2> timers;
+    std::array<AiStats, 2> stats;
+    std::array<AiFunc, 2> ai;
+    for (int i = 0; i < 2; ++i) {
+        auto aiFunc = getAi(opts.ai[i], opts.timeLimit_sec, searchThreads,
+                            stats[i]);
+        if (!aiFunc) {
+            std::cerr << "unknown AI '" << opts.ai[i] << "'\n";
+            usage();
+            return EXIT_FAILURE;
+        }
+        ai[i] = timed(aiFunc, timers[i]);
+    }
+    if (opts.hasSeed) {
+        setRandomSeed(opts.seed);
+    }
+
+    UnitTypeMap unitRef;
+    if (!loadGameData(unitRef)) {
+        return EXIT_FAILURE;
+    }
+    rapidjson::Document doc;
+    if (!jsonParse(opts.scenarioFile, doc)) {
+        return EXIT_FAILURE;
+    }
+    auto grid = makeBattleGrid();
+    auto scenario = parseScenario(doc, unitRef, *grid);
+    if (scenario.units.empty()) {
+        std::cerr << "Error: no units in scenario" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    GameState gs{*grid};
+    for (int i = 0; i < 2; ++i) {
+        gs.setCommander(scenario.commanders[i], i);
+    }
+    int entityId = 0;
+    for (auto unit : scenario.units) {
+        unit.entityId = entityId++;
+        gs.addUnit(unit);
+    }
+    gs.nextTurn();
+
+    auto start = BattleClock::now();
+    auto result = estimateBattle(gs, ai, opts.numBattles, opts.numThreads);
+    std::chrono::duration<double> elapsed = BattleClock::now() - start;
+
+    // Intervals are 95% confidence.
+    std::cout << std::fixed << std::setprecision(1) << result.numBattles <<
+        " battles in " << elapsed.count() << " sec\n";
+    for (int i = 0; i < 2; ++i) {
+        double moves = timers[i].moves;
+        double perMove = moves > 0 ?
+            timers[i].elapsed_usec / moves / 1000000.0 : 0.0;
+        std::cout << "team " << i + 1 << " (" << opts.ai[i] << "): wins ";
+        printEstimate(result.winProb[i], 100.0);
+        std::cout << "%, score ";
+        printEstimate(result.score[i], 1.0);
+        std::cout << ", " << std::setprecision(3) << perMove <<
+            " sec per move\n" << std::setprecision(1);
+        // Only the alpha-beta searches keep statistics.
+        if (opts.showStats && stats[i].searches > 0) {
+            std::cout << "    search: " << stats[i].total <<
+                ", average depth " <<
+                double(stats[i].sumDepth) / stats[i].searches << '\n';
+        }
+    }
+    std::cout << "draws: ";
+    printEstimate(result.drawProb, 100.0);
+    std::cout << "%\nlength: ";
+    printEstimate(result.rounds, 1.0);
+    std::cout << " rounds\n";
+    for (auto r = 0u; r < result.roundCounts.size(); ++r) {
+        if (result.roundCounts[r] > 0) {
+            std::cout << "    round " << r << ": " <<
+                result.roundCounts[r] << '\n';
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "estimator.h"
+
+#include "GameState.h"
+#include "algo.h"
+#include "boost/thread/thread.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    // Two-sided 95% confidence.
+    const double Z_95 = 1.96;
+
+    // Running totals of one quantity over a set of battles.
+    struct Sum
+    {
+        double total;
+        double totalSquares;
+
+        Sum() : total{0.0}, totalSquares{0.0} {}
+
+        void add(double x)
+        {
+            total += x;
+            totalSquares += x * x;
+        }
+
+        Sum & operator+=(const Sum &rhs)
+        {
+            total += rhs.total;
+            totalSquares += rhs.totalSquares;
+            return *this;
+        }
+    };
+
+    // Everything one worker thread learned from its battles.
+    struct Tally
+    {
+        int numBattles;
+        std::array<int, 3> wins;  // team 0, team 1, draw
+        std::array<Sum, 2> score;
+        Sum rounds;
+        std::vector<int> roundCounts;
+
+        Tally() : numBattles{0}, wins(), score(), rounds{}, roundCounts{}
+        {
+            wins.fill(0);
+        }
+
+        Tally & operator+=(const Tally &rhs)
+        {
+            numBattles += rhs.numBattles;
+            for (auto i = 0u; i < wins.size(); ++i) {
+                wins[i] += rhs.wins[i];
+            }
+            for (auto i = 0u; i < score.size(); ++i) {
+                score[i] += rhs.score[i];
+            }
+            rounds += rhs.rounds;
+            if (roundCounts.size() < rhs.roundCounts.size()) {
+                roundCounts.resize(rhs.roundCounts.size(), 0);
+            }
+            for (auto i = 0u; i < rhs.roundCounts.size(); ++i) {
+                roundCounts[i] += rhs.roundCounts[i];
+            }
+            return *this;
+        }
+    };
+
+    // Normal approximation, good enough for the thousands of battles this is
+    // meant for.
+    Estimate meanEstimate(const Sum &sum, int n)
+    {
+        Estimate est;
+        if (n <= 0) return est;
+
+        double mean = sum.total / n;
+        double variance = std::max(sum.totalSquares / n - mean * mean, 0.0);
+        double halfWidth = Z_95 * sqrt(variance / n);
+        est.value = mean;
+        est.low = mean - halfWidth;
+        est.high = mean + halfWidth;
+        return est;
+    }
+
+    // Wilson score interval, which behaves when the proportion is near 0 or
+    // 1 (one side almost always wins).
+    // source: http://en.wikipedia.org/wiki/Binomial_proportion_confidence_interval
+    Estimate proportionEstimate(int successes, int n)
+    {
+        Estimate est;
+        if (n <= 0) return est;
+
+        double p = static_cast<double>(successes) / n;
+        double z2 = Z_95 * Z_95;
+        double denom = 1.0 + z2 / n;
+        double center = (p + z2 / (2 * n)) / denom;
+        double halfWidth = Z_95 * sqrt(p * (1 - p) / n + z2 / (4 * n * n)) /
+            denom;
+        est.value = p;
+        est.low = std::max(center - halfWidth, 0.0);
+        est.high = std::min(center + halfWidth, 1.0);
+        return est;
+    }
+
+    void playBattle(GameState gs, const std::array<AiFunc, 2> &ai,
+                    Tally &tally)
+    {
+        gs.setExecFunc([&gs] (Action action) {
+            action.damage = gs.computeDamage(action);
+            gs.execute(action);
+        });
+
+        while (!gs.isGameOver()) {
+            auto action = ai[gs.getActiveTeam()](gs);
+            gs.runActionSeq(action);
+            gs.nextTurn();
+        }
+
+        auto score = gs.getScore();
+        int winner = 2;
+        if (score[0] > 0) {
+            winner = 0;
+        }
+        else if (score[1] > 0) {
+            winner = 1;
+        }
+
+        int round = gs.getRound();
+        ++tally.numBattles;
+        ++tally.wins[winner];
+        tally.score[0].add(score[0]);
+        tally.score[1].add(score[1]);
+        tally.rounds.add(round);
+        if (round >= static_cast<int>(tally.roundCounts.size())) {
+            tally.roundCounts.resize(round + 1, 0);
+        }
+        ++tally.roundCounts[round];
+    }
+}
+
+Estimate::Estimate()
+    : value{0.0},
+    low{0.0},
+    high{0.0}
+{
+}
+
+BattleEstimate::BattleEstimate()
+    : numBattles{0},
+    winProb(),
+    drawProb{},
+    score(),
+    rounds{},
+    roundCounts{}
+{
+}
+
+BattleEstimate estimateBattle(const GameState &start,
+                              const std::array<AiFunc, 2> &ai,
+                              int numBattles,
+                              int numThreads)
+{
+    assert(ai[0] && ai[1]);
+    if (numThreads <= 0) {
+        numThreads = std::max<int>(boost::thread::hardware_concurrency(), 1);
+    }
+    numThreads = std::max(std::min(numThreads, numBattles), 1);
+
+    // Hand out battles one at a time so a thread that gets a few long ones
+    // doesn't hold everyone up.  Each battle rolls dice from its own random
+    // stream, so the results don't depend on which thread ran it.
+    auto seed = randomGenerator()();
+    std::atomic<int> nextBattle{0};
+    std::vector<Tally> tallies(numThreads);
+    auto runWorker = [&] (Tally &tally) {
+        auto savedGenerator = randomGenerator();
+        int battle = 0;
+        while ((battle = nextBattle++) < numBattles) {
+            randomGenerator().seed(seed, battle);
+            playBattle(start, ai, tally);
+        }
+        randomGenerator() = savedGenerator;
+    };
+
+    boost::thread_group threads;
+    for (int i = 1; i < numThreads; ++i) {
+        auto &tally = tallies[i];
+        threads.create_thread([&] {runWorker(tally);});
+    }
+    runWorker(tallies[0]);
+    threads.join_all();
+
+    Tally total;
+    for (const auto &tally : tallies) {
+        total += tally;
+    }
+
+    BattleEstimate result;
+    int n = total.numBattles;
+    result.numBattles = n;
+    for (int i = 0; i < 2; ++i) {
+        result.winProb[i] = proportionEstimate(total.wins[i], n);
+        result.score[i] = meanEstimate(total.score[i], n);
+    }
+    result.drawProb = proportionEstimate(total.wins[2], n);
+    result.rounds = meanEstimate(total.rounds, n);
+    result.roundCounts = std::move(total.roundCounts);
+    return result;
+}
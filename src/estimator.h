@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include "Action.h"
+#include <array>
+#include <functional>
+#include <vector>
+
+class GameState;
+
+// Any of the AI functions from ai.h, or a lambda wrapping one of them.
+using AiFunc = std::function<Action (const GameState &)>;
+
+// Sample mean with a 95% confidence interval.
+struct Estimate
+{
+    double value;
+    double low;
+    double high;
+
+    Estimate();
+};
+
+// Outcome of many battles played from the same starting point.
+struct BattleEstimate
+{
+    int numBattles;
+    std::array<Estimate, 2> winProb;
+    Estimate drawProb;
+    std::array<Estimate, 2> score;  // getScore() at the end of the battle
+    Estimate rounds;
+    std::vector<int> roundCounts;  // number of battles that ended in round i
+
+    BattleEstimate();
+};
+
+// Play out the battle from 'start' many times with real damage rolls, each
+// team choosing actions with its own AI.  The active unit of 'start' must be
+// ready to act (nextTurn() has been called).  Battles are spread over
+// 'numThreads' threads (one per core if 0).  Every thread has its own copy of
+// the game state.  Battle i uses stream i of a seed drawn from the calling
+// thread's generator, so with deterministic AIs the results only depend on
+// how that generator was seeded.  The AIs are called from several threads at
+// once, so unless 'numThreads' is 1, give their searches one thread each (see
+// ai.h).
+BattleEstimate estimateBattle(const GameState &start,
+                              const std::array<AiFunc, 2> &ai,
+                              int numBattles,
+                              int numThreads = 0);
+
+#endif
@@ -42,24 +42,24 @@ std::ostream & operator<<(std::ostream &ostr, const Point &rhs)
 }
 
 // source: Battle for Wesnoth, distance_between() in map_location.cpp.
-Sint16 hexDist(const Point &h1, const Point &h2)
+int16_t hexDist(const Point &h1, const Point &h2)
 {
     if (h1 == hInvalid || h2 == hInvalid) {
         return Sint16_max;
     }
 
-    Sint16 dx = abs(h1.x - h2.x);
-    Sint16 dy = abs(h1.y - h2.y);
+    int16_t dx = abs(h1.x - h2.x);
+    int16_t dy = abs(h1.y - h2.y);
 
     // Since the x-axis of the hex grid is staggered, we need to add a step in
     // certain cases.
-    Sint16 vPenalty = 0;
+    int16_t vPenalty = 0;
     if ((h1.y < h2.y && h1.x % 2 == 0 && h2.x % 2 == 1) ||
         (h1.y > h2.y && h1.x % 2 == 1 && h2.x % 2 == 0)) {
         vPenalty = 1;
     }
 
-    return std::max(dx, static_cast<Sint16>(dy + vPenalty + dx / 2));
+    return std::max(dx, static_cast<int16_t>(dy + vPenalty + dx / 2));
 }
 
 Point adjacent(const Point &hSrc, Dir d)
@@ -168,10 +168,10 @@ int findClosest(const Point &hTarget, const std::vector<Point> &hexes)
 {
     int closest = -1;
     int size = static_cast<int>(hexes.size());
-    Sint16 bestSoFar = Sint16_max;
+    int16_t bestSoFar = Sint16_max;
 
     for (int i = 0; i < size; ++i) {
-        Sint16 dist = hexDist(hTarget, hexes[i]);
+        int16_t dist = hexDist(hTarget, hexes[i]);
         if (dist < bestSoFar) {
             closest = i;
             bestSoFar = dist;
@@ -201,14 +201,14 @@ Point hexFromPixel(int px, int py)
     // / \_    tilingHeight
     // \_/ \  _
     //   \_/
-    const Sint16 tilingWidth = pHexSize * 3 / 2;
-    const Sint16 tilingHeight = pHexSize;
+    const int16_t tilingWidth = pHexSize * 3 / 2;
+    const int16_t tilingHeight = pHexSize;
 
     // I'm not going to pretend to know why the rest of this works.
-    Sint16 hx = px / tilingWidth * 2;
-    Sint16 xMod = px % tilingWidth;
-    Sint16 hy = py / tilingHeight;
-    Sint16 yMod = py % tilingHeight;
+    int16_t hx = px / tilingWidth * 2;
+    int16_t xMod = px % tilingWidth;
+    int16_t hy = py / tilingHeight;
+    int16_t yMod = py % tilingHeight;
 
     if (yMod < tilingHeight / 2) {
         if ((xMod * 2 + yMod) < (pHexSize / 2)) {
@@ -13,17 +13,16 @@
 #ifndef HEX_UTILS_H
 #define HEX_UTILS_H
 
-#include "SDL_stdinc.h"
-#include "SDL_video.h"
 #include "iterable_enum_class.h"
+#include <cstdint>
 #include <iosfwd>
 #include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
-const Sint16 Sint16_min = std::numeric_limits<Sint16>::min();
-const Sint16 Sint16_max = std::numeric_limits<Sint16>::max();
+const int16_t Sint16_min = std::numeric_limits<int16_t>::min();
+const int16_t Sint16_max = std::numeric_limits<int16_t>::max();
 
 struct Point
 {
@@ -35,7 +34,7 @@ struct Point
 };
 
 const Point hInvalid;
-const Sint16 pHexSize = 72;
+const int16_t pHexSize = 72;
 
 bool operator==(const Point &lhs, const Point &rhs);
 bool operator!=(const Point &lhs, const Point &rhs);
@@ -67,7 +66,7 @@ enum class Dir {N, NE, SE, S, SW, NW, _last, _first = N};
 ITERABLE_ENUM_CLASS(Dir);
 
 // Distance between hexes, 1 step per tile.
-Sint16 hexDist(const Point &h1, const Point &h2);
+int16_t hexDist(const Point &h1, const Point &h2);
 
 // Return the hex adjacent to the source hex in the given direction.  No
 // bounds checking.
@@ -24,11 +24,13 @@ bool jsonParse(const char *filename, rapidjson::Document &doc)
 {
     boost::filesystem::path dataPath{"../data"};
     dataPath /= filename;
-    std::shared_ptr<FILE> fp{fopen(dataPath.string().c_str(), "r"), fclose};
-    if (!fp) {
+    // Don't hand a null FILE to the shared_ptr, it would call fclose() on it.
+    auto rawFp = fopen(dataPath.string().c_str(), "r");
+    if (!rawFp) {
         std::cerr << "Couldn't find file " << dataPath.string() << '\n';
         return false;
     }
+    std::shared_ptr<FILE> fp{rawFp, fclose};
 
     rapidjson::FileStream file(fp.get());
     if (doc.ParseStream<0>(file).HasParseError()) {
@@ -0,0 +1,178 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "scenario.h"
+
+#include "Effects.h"
+#include "Spells.h"
+#include "algo.h"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    // Unit placement on the grid.
+    // team 1 on the left, team 2 on the right
+    const Point unitPos[] = {{1,0}, {1,1}, {1,2}, {1,3},  // team 1 row 1
+                             {0,1}, {0,2}, {0,3},         // team 1 row 2
+                             {3,0}, {3,1}, {3,2}, {3,3},  // team 2 row 1
+                             {4,1}, {4,2}, {4,3}};        // team 2 row 2
+
+    // Map unit position strings used by JSON data to 'unitPos' array indexes.
+    const std::unordered_map<std::string, int> mapUnitPos = {
+        {"t1p1", 0}, {"t1p2", 1}, {"t1p3", 2}, {"t1p4", 3},
+        {"t1p5", 4}, {"t1p6", 5}, {"t1p7", 6},
+        {"t2p1", 7}, {"t2p2", 8}, {"t2p3", 9}, {"t2p4", 10},
+        {"t2p5", 11}, {"t2p6", 12}, {"t2p7", 13}
+    };
+
+    bool parseUnits(const rapidjson::Document &doc, UnitTypeMap &unitRef)
+    {
+        bool unitAdded = false;
+        for (auto i = doc.MemberBegin(); i != doc.MemberEnd(); ++i) {
+            if (!i->value.IsObject()) {
+                std::cerr << "units: skipping id '" << i->name.GetString() <<
+                    "'\n";
+                continue;
+            }
+
+            unitRef.emplace(i->name.GetString(), UnitType(i->value));
+            unitAdded = true;
+        }
+
+        return unitAdded;
+    }
+
+    void parseOptions(const rapidjson::Value &json, Scenario &scenario)
+    {
+        if (json.HasMember("players")) {
+            const rapidjson::Value &players = json["players"];
+            for (auto i = 0u; i < players.Size() && i < 2; ++i) {
+                auto player = to_lower(players[i].GetString());
+                if (player == "ai") {
+                    scenario.players[i] = Player::AI;
+                }
+                else if (player == "mcts") {
+                    scenario.players[i] = Player::MCTS;
+                }
+            }
+        }
+    }
+}
+
+std::unique_ptr<HexGrid> makeBattleGrid()
+{
+    auto grid = make_unique<HexGrid>(5, 5);
+    grid->erase(0, 0);
+    grid->erase(0, 4);
+    grid->erase(1, 4);
+    grid->erase(3, 4);
+    grid->erase(4, 0);
+    grid->erase(4, 4);
+    return grid;
+}
+
+bool loadGameData(UnitTypeMap &unitRef)
+{
+    if (!initEffectCache("effects.json")) {
+        std::cerr << "Warning: no effect definitions loaded" << std::endl;
+    }
+    if (!initSpellCache("spells.json")) {
+        std::cerr << "Warning: no spell definitions loaded" << std::endl;
+    }
+
+    rapidjson::Document unitsDoc;
+    if (!jsonParse("units.json", unitsDoc)) {
+        return false;
+    }
+    if (!parseUnits(unitsDoc, unitRef)) {
+        std::cerr << "Error: no unit definitions loaded" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+Scenario::Scenario()
+    : units{},
+    commanders{},
+    players{{Player::HUMAN, Player::HUMAN}}
+{
+}
+
+Scenario parseScenario(const rapidjson::Document &doc,
+                       const UnitTypeMap &unitRef,
+                       const HexGrid &grid)
+{
+    Scenario scenario;
+
+    if (grid.size() > MAX_MASK_HEXES) {
+        std::cerr << "Error: battlefield has " << grid.size() <<
+            " hexes, at most " << MAX_MASK_HEXES << " are supported\n";
+        return scenario;
+    }
+
+    for (auto i = doc.MemberBegin(); i != doc.MemberEnd(); ++i) {
+        if (!i->value.IsObject()) {
+            std::cerr << "scenario: skipping unit at position '"
+                << i->name.GetString() << "'\n";
+            continue;
+        }
+
+        // Compute battlefield position from location id.
+        std::string posStr = i->name.GetString();
+        auto posIter = mapUnitPos.find(posStr);
+        if (posIter == std::end(mapUnitPos)) {
+            if (posStr == "options") {
+                parseOptions(i->value, scenario);
+            }
+            else if (posStr == "cmdr1") {
+                scenario.commanders[0] = Commander(i->value);
+            }
+            else if (posStr == "cmdr2") {
+                scenario.commanders[1] = Commander(i->value);
+            }
+            else {
+                std::cerr << "scenario: skipping unit at position '"
+                    << i->name.GetString() << "'\n";
+            }
+            continue;
+        }
+        int posIdx = posIter->second;
+
+        const auto &json = i->value;
+
+        // Ensure we recognize the unit id.
+        std::string name;
+        if (json.HasMember("id")) {
+            name = json["id"].GetString();
+        }
+        auto typeIter = unitRef.find(name);
+        if (typeIter == std::end(unitRef)) {
+            std::cerr << "scenario: skipping unit with unknown id '" <<
+                name << "'\n";
+            continue;
+        }
+
+        Unit newUnit(typeIter->second);
+        newUnit.team = (posIdx < 7) ? 0 : 1;
+        newUnit.aHex = grid.aryFromHex(unitPos[posIdx]);
+        newUnit.face = (newUnit.team == 0) ? Facing::RIGHT : Facing::LEFT;
+        if (json.HasMember("num")) {
+            newUnit.num = json["num"].GetInt();
+        }
+        scenario.units.push_back(newUnit);
+    }
+
+    return scenario;
+}
@@ -0,0 +1,53 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "Commander.h"
+#include "HexGrid.h"
+#include "Unit.h"
+#include "UnitType.h"
+#include "json_utils.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+// Every battle is fought on the same map.
+std::unique_ptr<HexGrid> makeBattleGrid();
+
+// Load effects, spells, and unit definitions from the data directory.  Return
+// false if there's nothing to fight with.  Images and sounds are left to the
+// front end (see UnitArt and EffectArt).
+bool loadGameData(UnitTypeMap &unitRef);
+
+enum class Player { HUMAN, AI, MCTS };
+
+// Everything a scenario file sets up.  Units have their team, position, and
+// size, but no entity ids yet.
+struct Scenario
+{
+    std::vector<Unit> units;
+    std::array<Commander, 2> commanders;
+    std::array<Player, 2> players;
+
+    Scenario();
+};
+
+// Skip anything in the file we don't recognize, with a warning.  GameState
+// tracks occupied hexes in a HexMask, so a grid with more than MAX_MASK_HEXES
+// hexes is an error and the scenario comes back without any units.
+Scenario parseScenario(const rapidjson::Document &doc,
+                       const UnitTypeMap &unitRef,
+                       const HexGrid &grid);
+
+#endif
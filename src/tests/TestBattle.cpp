@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "TestBattle.h"
+
+#include "algo.h"
+#include "json_utils.h"
+#include "scenario.h"
+#include "boost/test/unit_test.hpp"
+
+const UnitTypeMap & testUnitTypes()
+{
+    static UnitTypeMap unitRef;
+    if (unitRef.empty()) {
+        BOOST_REQUIRE(loadGameData(unitRef));
+    }
+    return unitRef;
+}
+
+TestBattle::TestBattle()
+    : TestBattle(makeBattleGrid())
+{
+}
+
+TestBattle::TestBattle(std::unique_ptr<HexGrid> bfGrid)
+    : grid{std::move(bfGrid)},
+    gs{make_unique<GameState>(*grid)},
+    ids_{}
+{
+    testUnitTypes();
+    gs->setSimMode();
+}
+
+TestBattle::TestBattle(const char *scenarioFile)
+    : TestBattle()
+{
+    rapidjson::Document doc;
+    BOOST_REQUIRE(jsonParse(scenarioFile, doc));
+    auto scenario = parseScenario(doc, testUnitTypes(), *grid);
+
+    for (int i = 0; i < 2; ++i) {
+        gs->setCommander(scenario.commanders[i], i);
+    }
+    for (auto unit : scenario.units) {
+        unit.entityId = ids_.size();
+        ids_.push_back(unit.entityId);
+        gs->addUnit(unit);
+    }
+}
+
+int TestBattle::addUnit(const std::string &type, int team, int num,
+                        const Point &hex)
+{
+    auto iter = testUnitTypes().find(type);
+    BOOST_REQUIRE(iter != testUnitTypes().end());
+    return addUnit(iter->second, team, num, hex);
+}
+
+int TestBattle::addUnit(const UnitType &type, int team, int num,
+                        const Point &hex)
+{
+    Unit unit{type};
+    unit.entityId = ids_.size();
+    ids_.push_back(unit.entityId);
+    unit.team = team;
+    unit.num = num;
+    unit.aHex = grid->aryFromHex(hex);
+    unit.face = (team == 0) ? Facing::RIGHT : Facing::LEFT;
+    gs->addUnit(unit);
+    return unit.entityId;
+}
+
+void TestBattle::start()
+{
+    gs->nextTurn();
+}
+
+const std::vector<int> & TestBattle::unitIds() const
+{
+    return ids_;
+}
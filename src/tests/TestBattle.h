@@ -0,0 +1,53 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#ifndef TEST_BATTLE_H
+#define TEST_BATTLE_H
+
+#include "GameState.h"
+#include "HexGrid.h"
+#include "UnitType.h"
+#include "hex_utils.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Game data shared by all tests, loaded on first use.
+const UnitTypeMap & testUnitTypes();
+
+// A battle on the standard grid, either from a scenario file or with units
+// placed one at a time.  Damage is simulated, no callbacks are run.
+struct TestBattle
+{
+    std::unique_ptr<HexGrid> grid;
+    std::unique_ptr<GameState> gs;
+
+    TestBattle();
+    explicit TestBattle(std::unique_ptr<HexGrid> bfGrid);
+    explicit TestBattle(const char *scenarioFile);
+
+    // Add 'num' units of the given type.  Return the new unit's entity id.  A
+    // type not from testUnitTypes() must outlive the battle.
+    int addUnit(const std::string &type, int team, int num, const Point &hex);
+    int addUnit(const UnitType &type, int team, int num, const Point &hex);
+
+    // Call after adding units to start the first round.
+    void start();
+
+    // Entity ids of every unit added, in order.
+    const std::vector<int> & unitIds() const;
+
+private:
+    std::vector<int> ids_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "TestBattle.h"
+
+#include "Traits.h"
+#include "algo.h"
+#include "boost/test/unit_test.hpp"
+#include <cmath>
+
+BOOST_AUTO_TEST_SUITE(game_state)
+
+// Unpacking a snapshot must restore the units, the hash, and the scores
+// exactly, no matter how far the game went on after packing it.
+BOOST_AUTO_TEST_CASE(pack_round_trip)
+{
+    setRandomSeed(1);
+    TestBattle battle{"scenario.json"};
+    battle.start();
+    auto &gs = *battle.gs;
+
+    for (int turn = 0; turn < 40 && !gs.isGameOver(); ++turn) {
+        auto ps = gs.pack();
+
+        GameState later{gs};
+        for (int i = 0; i < 5 && !later.isGameOver(); ++i) {
+            auto actions = later.getPossibleActions();
+            later.runActionSeq(*randomElem(actions));
+            later.nextTurn();
+        }
+        later.unpack(ps);
+
+        BOOST_CHECK_EQUAL(later.getHash(), gs.getHash());
+        BOOST_CHECK(later.getScore() == gs.getScore());
+        BOOST_CHECK_EQUAL(later.getRound(), gs.getRound());
+        BOOST_CHECK_EQUAL(later.getActiveUnit().entityId,
+                          gs.getActiveUnit().entityId);
+        for (auto id : battle.unitIds()) {
+            const auto &orig = gs.getUnit(id);
+            const auto &unit = later.getUnit(id);
+            BOOST_CHECK_EQUAL(unit.num, orig.num);
+            BOOST_CHECK_EQUAL(unit.hpLeft, orig.hpLeft);
+            BOOST_CHECK_EQUAL(unit.aHex, orig.aHex);
+            BOOST_CHECK_EQUAL(unit.retaliated, orig.retaliated);
+            BOOST_CHECK(unit.effect.type == orig.effect.type);
+            BOOST_CHECK_EQUAL(unit.effect.roundsLeft, orig.effect.roundsLeft);
+            if (unit.isAlive()) {
+                BOOST_CHECK_EQUAL(later.getUnitAt(unit.aHex).entityId, id);
+            }
+        }
+
+        auto actions = gs.getPossibleActions();
+        gs.runActionSeq(*randomElem(actions));
+        gs.nextTurn();
+    }
+}
+
+// The largest grid GameState supports puts a unit in the highest bit of the
+// occupancy masks.
+BOOST_AUTO_TEST_CASE(largest_grid)
+{
+    TestBattle battle{make_unique<HexGrid>(8, 8)};
+    BOOST_REQUIRE_EQUAL(battle.grid->size(), MAX_MASK_HEXES);
+    int lastHex = MAX_MASK_HEXES - 1;
+    auto corner = battle.addUnit("peasant", 0, 10,
+                                 battle.grid->hexFromAry(lastHex));
+    auto enemy = battle.addUnit("peasant", 1, 10, Point{6, 7});
+    battle.start();
+    auto &gs = *battle.gs;
+
+    BOOST_CHECK(!gs.isHexOpen(lastHex));
+    BOOST_CHECK_EQUAL(gs.getUnitAt(lastHex).entityId, corner);
+    auto adj = gs.getAdjEnemies(enemy);
+    BOOST_REQUIRE_EQUAL(adj.size(), 1u);
+    BOOST_CHECK_EQUAL(adj[0], corner);
+
+    gs.moveUnit(corner, battle.grid->aryFromHex(5, 5));
+    BOOST_CHECK(gs.isHexOpen(lastHex));
+    BOOST_CHECK(gs.getAdjEnemies(enemy).empty());
+}
+
+// Merging chance outcomes mustn't change the average damage, or Life Drain
+// heals less in the search than in the real game.
+BOOST_AUTO_TEST_CASE(merged_outcomes_keep_mean_damage)
+{
+    // A vampire with a wider damage range than usual, so each roll kills a
+    // different number of peasants.
+    UnitType drainer = testUnitTypes().at("vampire");
+    BOOST_REQUIRE(drainer.traits & traitBit(Trait::LIFE_DRAIN));
+    drainer.minDmg = 1;
+    drainer.maxDmg = 12;
+
+    TestBattle battle;
+    auto att = battle.addUnit(drainer, 0, 10, Point{1, 1});
+    auto def = battle.addUnit("peasant", 1, 100, Point{2, 1});
+    battle.start();
+    const auto &gs = *battle.gs;
+    BOOST_REQUIRE_EQUAL(gs.getActiveUnit().entityId, att);
+
+    Action attack;
+    for (const auto &action : gs.getPossibleActions()) {
+        if (action.type == ActionType::ATTACK && action.defender == def &&
+            action.path.size() == 1)
+        {
+            attack = action;
+        }
+    }
+    BOOST_REQUIRE(attack.type == ActionType::ATTACK);
+
+    auto results = gs.getDamageDistribution(attack);
+    auto outcomes = gs.getDamageOutcomes(attack);
+    BOOST_REQUIRE_GT(results.size(), 4u);
+    BOOST_REQUIRE_LE(outcomes.size(), 4u);
+
+    double expected = 0.0;
+    for (const auto &r : results) {
+        expected += r.damage * r.probability;
+    }
+    double searched = 0.0;
+    double probSum = 0.0;
+    for (const auto &o : outcomes) {
+        searched += o.damage * o.probability;
+        probSum += o.probability;
+
+        // Outcomes must agree with what executing that damage does.
+        auto result = gs.getUnit(def).damageResult(o.damage);
+        BOOST_CHECK_EQUAL(o.kills, result.first);
+        BOOST_CHECK_EQUAL(o.hpLeft, result.second);
+    }
+    BOOST_CHECK_CLOSE(probSum, 1.0, 1e-6);
+    BOOST_CHECK_LE(std::abs(searched - expected), 1.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
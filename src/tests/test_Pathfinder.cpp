@@ -0,0 +1,60 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "HexGrid.h"
+#include "Pathfinder.h"
+#include "boost/test/unit_test.hpp"
+
+BOOST_AUTO_TEST_SUITE(pathfinder)
+
+// On an open grid, everything within range is reachable by a shortest path,
+// whichever node the search starts from.
+BOOST_AUTO_TEST_CASE(reachable_open_grid)
+{
+    HexGrid grid{5, 5};
+    auto pf = makePathfinder(grid.size(), [&] (int n, NodeList &nbrs) {
+        for (auto nbr : grid.aryNeighbors(n)) {
+            nbrs.push_back(nbr);
+        }
+    });
+
+    for (int start = 0; start < grid.size(); ++start) {
+        for (int maxDist = 0; maxDist <= 3; ++maxDist) {
+            auto reachable = pf.getReachable(start, maxDist);
+            BOOST_REQUIRE(!reachable.entries.empty());
+            BOOST_CHECK_EQUAL(reachable.entries.front().node, start);
+            BOOST_CHECK(!reachable.find(-1));
+            BOOST_CHECK(!reachable.find(grid.size()));
+
+            auto numInRange = 0u;
+            for (int n = 0; n < grid.size(); ++n) {
+                int dist = grid.aryDist(start, n);
+                if (dist > maxDist) {
+                    BOOST_CHECK(!reachable.contains(n));
+                    continue;
+                }
+
+                ++numInRange;
+                auto entry = reachable.find(n);
+                BOOST_REQUIRE(entry);
+                BOOST_CHECK_EQUAL(entry->dist, dist);
+                auto path = reachable.getPathTo(n);
+                BOOST_REQUIRE_EQUAL(path.size(), dist + 1u);
+                BOOST_CHECK_EQUAL(path.front(), start);
+                BOOST_CHECK_EQUAL(path.back(), n);
+            }
+            BOOST_CHECK_EQUAL(reachable.entries.size(), numInRange);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "TestBattle.h"
+
+#include "Action.h"
+#include "ai.h"
+#include "boost/test/unit_test.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    bool sameAction(const Action &lhs, const Action &rhs)
+    {
+        return lhs.type == rhs.type && lhs.attacker == rhs.attacker &&
+            lhs.defender == rhs.defender && lhs.aTgt == rhs.aTgt &&
+            std::equal(lhs.path.begin(), lhs.path.end(), rhs.path.begin()) &&
+            lhs.path.size() == rhs.path.size();
+    }
+
+    bool isLegal(const GameState &gs, const Action &action)
+    {
+        for (const auto &legal : gs.getPossibleActions()) {
+            if (sameAction(legal, action)) return true;
+        }
+        return false;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ai)
+
+// Helper threads only feed the shared table, so at a fixed depth the main
+// thread should settle on the move it would have found by itself.
+BOOST_AUTO_TEST_CASE(parallel_matches_single_thread)
+{
+    TestBattle battle{"scenario.json"};
+    battle.start();
+    auto &gs = *battle.gs;
+
+    const double noTimeLimit = 60.0;
+    const int depth = 3;
+    for (int turn = 0; turn < 6 && !gs.isGameOver(); ++turn) {
+        auto single = aiParallel(gs, 1, noTimeLimit, nullptr, depth);
+        auto parallel = aiParallel(gs, 2, noTimeLimit, nullptr, depth);
+        BOOST_CHECK(isLegal(gs, parallel));
+        BOOST_CHECK(sameAction(single, parallel));
+
+        gs.runActionSeq(single);
+        gs.nextTurn();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
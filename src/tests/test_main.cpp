@@ -0,0 +1,16 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+// Unit tests for the battle core.  Game data is read from ../data, so run
+// them from the src directory (ctest does this).
+#define BOOST_TEST_MODULE battle-sim
+#include "boost/test/included/unit_test.hpp"
@@ -0,0 +1,38 @@
+/*
+    Copyright (C) 2014 by Michael Kristofik <kristo605@gmail.com>
+    Part of the battle-sim project.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    or at your option any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY.
+
+    See the COPYING.txt file for more details.
+*/
+#include "TestBattle.h"
+
+#include "HexGrid.h"
+#include "json_utils.h"
+#include "scenario.h"
+#include "boost/test/unit_test.hpp"
+
+BOOST_AUTO_TEST_SUITE(scenario)
+
+// GameState can only track MAX_MASK_HEXES hexes, one past that is an error
+// in every build.
+BOOST_AUTO_TEST_CASE(grid_size_limit)
+{
+    rapidjson::Document doc;
+    BOOST_REQUIRE(jsonParse("scenario.json", doc));
+
+    HexGrid largest{8, 8};
+    BOOST_REQUIRE_EQUAL(largest.size(), MAX_MASK_HEXES);
+    BOOST_CHECK(!parseScenario(doc, testUnitTypes(), largest).units.empty());
+
+    HexGrid tooBig{13, 5};
+    BOOST_REQUIRE_EQUAL(tooBig.size(), MAX_MASK_HEXES + 1);
+    BOOST_CHECK(parseScenario(doc, testUnitTypes(), tooBig).units.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()